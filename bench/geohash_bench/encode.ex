@@ -5,6 +5,9 @@ defmodule GeohashBench.Encode do
         "encode with NIF" => fn length ->
           Geohash.Nif.encode(51.501568, -0.141257, length)
         end,
+        "encode_int with NIF" => fn length ->
+          Geohash.Nif.encode_int(51.501568, -0.141257, length)
+        end,
         "encode with Elixir" => fn length ->
           Geohash.encode(51.501568, -0.141257, length)
         end
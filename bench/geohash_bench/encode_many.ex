@@ -0,0 +1,36 @@
+defmodule GeohashBench.EncodeMany do
+  def bench_spec do
+    [
+      benchmarks: %{
+        "encode_many with NIF (list)" => fn {points, _packed} ->
+          Geohash.Nif.encode_many(points, 11, :binary)
+        end,
+        "encode_many with NIF (packed)" => fn {_points, packed} ->
+          Geohash.Nif.encode_many(packed, 11, :binary)
+        end,
+        "encode with NIF" => fn {points, _packed} ->
+          Enum.map(points, fn {lat, lon} -> Geohash.Nif.encode(lat, lon, 11) end)
+        end,
+        "encode with Elixir" => fn {points, _packed} ->
+          Enum.map(points, fn {lat, lon} -> Geohash.encode(lat, lon, 11) end)
+        end
+      },
+      inputs: %{
+        "points: 1_000" => points(1_000),
+        "points: 10_000" => points(10_000),
+        "points: 100_000" => points(100_000)
+      }
+    ]
+  end
+
+  defp points(count) do
+    points =
+      for _ <- 1..count do
+        {:rand.uniform() * 180 - 90, :rand.uniform() * 360 - 180}
+      end
+
+    packed = for {lat, lon} <- points, into: <<>>, do: <<lat::float-native, lon::float-native>>
+
+    {points, packed}
+  end
+end
@@ -12,9 +12,22 @@
 #include <stdint.h>
 #include <assert.h>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HAVE_BMI2_DISPATCH 1
+#include <immintrin.h>
+#endif
+
 #include "geohash.h"
+#include "geohash_base32.h"
+
+#define MAX_HASH_LENGTH GEOHASH_MAX_HASH_LENGTH
+#define MAX_BITS_LENGTH GEOHASH_MAX_BITS_LENGTH
+/* characters translated at once by the bulk decoder */
+#define DECODE_CHUNK 4096
 
-#define MAX_HASH_LENGTH 22
+/* 2^32, the number of fixed-point cells a coordinate is quantized to */
+#define QUANTIZE_CELLS 4294967296.0
+#define QUANTIZE_MAX 0xFFFFFFFFu
 
 #define REFINE_RANGE(range, bits, offset)               \
   if (((bits) & (offset)) == (offset))                  \
@@ -71,27 +84,7 @@ static const char BORDERS_TABLE[8][9] = {
 
 bool GEOHASH_verify_hash(const char *hash, size_t len)
 {
-  const char *p;
-  unsigned char c;
-  p = hash;
-  while (len-- > 0)
-  {
-    c = toupper(*p++);
-    if (c < 0x30)
-    {
-      return false;
-    }
-    c -= 0x30;
-    if (c > 43)
-    {
-      return false;
-    }
-    if (BASE32_DECODE_TABLE[c] == -1)
-    {
-      return false;
-    }
-  }
-  return true;
+  return GEOHASH_base32_verify(hash, len);
 }
 
 uint64_t
@@ -128,69 +121,286 @@ GEOHASH_decode_to_bits(const char *hash, size_t len)
   return bits;
 }
 
-GEOHASH_area *
-GEOHASH_decode(const char *hash, size_t len)
+static inline void
+init_area(GEOHASH_area *area)
 {
-  const char *p;
-  unsigned char c;
-  char bits;
-  GEOHASH_area *area;
-  GEOHASH_range *range1, *range2, *range_tmp;
-
-  area = (GEOHASH_area *)malloc(sizeof(GEOHASH_area));
-  if (area == NULL)
-    return NULL;
-
   area->latitude.max = 90;
   area->latitude.min = -90;
   area->longitude.max = 180;
   area->longitude.min = -180;
+}
 
-  range1 = &area->longitude;
-  range2 = &area->latitude;
+/* even characters start with a longitude bit, odd ones with a latitude bit */
+static inline void
+refine_area(GEOHASH_area *area, size_t index, char bits)
+{
+  GEOHASH_range *range1, *range2;
 
-  p = hash;
+  range1 = index % 2 == 0 ? &area->longitude : &area->latitude;
+  range2 = index % 2 == 0 ? &area->latitude : &area->longitude;
 
-  while (len-- > 0)
+  REFINE_RANGE(range1, bits, 0x10);
+  REFINE_RANGE(range2, bits, 0x08);
+  REFINE_RANGE(range1, bits, 0x04);
+  REFINE_RANGE(range2, bits, 0x02);
+  REFINE_RANGE(range1, bits, 0x01);
+}
+
+bool
+GEOHASH_decode_into(const char *hash, size_t len, GEOHASH_area *area)
+{
+  size_t i;
+  unsigned char c;
+  char bits;
+
+  init_area(area);
+
+  for (i = 0; i < len; i++)
   {
 
-    c = toupper(*p++);
+    c = toupper(hash[i]);
     if (c < 0x30)
     {
-      free(area);
-      return NULL;
+      return false;
     }
     c -= 0x30;
     if (c > 43)
     {
-      free(area);
-      return NULL;
+      return false;
     }
     bits = BASE32_DECODE_TABLE[c];
     if (bits == -1)
     {
-      free(area);
-      return NULL;
+      return false;
     }
 
-    REFINE_RANGE(range1, bits, 0x10);
-    REFINE_RANGE(range2, bits, 0x08);
-    REFINE_RANGE(range1, bits, 0x04);
-    REFINE_RANGE(range2, bits, 0x02);
-    REFINE_RANGE(range1, bits, 0x01);
+    refine_area(area, i, bits);
+  }
+  return true;
+}
+
+GEOHASH_area *
+GEOHASH_decode(const char *hash, size_t len)
+{
+  GEOHASH_area *area;
 
-    range_tmp = range1;
-    range1 = range2;
-    range2 = range_tmp;
+  area = (GEOHASH_area *)malloc(sizeof(GEOHASH_area));
+  if (area == NULL)
+    return NULL;
+
+  if (!GEOHASH_decode_into(hash, len, area))
+  {
+    free(area);
+    return NULL;
   }
   return area;
 }
 
-char *
-GEOHASH_encode(double lat, double lon, unsigned int len)
+/*
+ * Hashes are translated to 5-bit values in chunks of DECODE_CHUNK
+ * characters with the bulk base32 kernel, the per character validation
+ * only runs again on the chunk holding an invalid hash.
+ */
+size_t
+GEOHASH_decode_many(const char *hashes, size_t count, size_t len, GEOHASH_area *areas)
+{
+  uint8_t values[DECODE_CHUNK];
+  size_t i, j, k, n, per_chunk;
+
+  if (len == 0 || len > DECODE_CHUNK)
+  {
+    for (i = 0; i < count; i++)
+    {
+      if (!GEOHASH_decode_into(hashes + i * len, len, &areas[i]))
+        return i;
+    }
+    return count;
+  }
+
+  per_chunk = DECODE_CHUNK / len;
+
+  for (i = 0; i < count; i += n)
+  {
+    n = count - i < per_chunk ? count - i : per_chunk;
+
+    if (!GEOHASH_base32_decode(hashes + i * len, n * len, values))
+    {
+      for (j = 0; j < n; j++)
+      {
+        if (!GEOHASH_decode_into(hashes + (i + j) * len, len, &areas[i + j]))
+          return i + j;
+      }
+    }
+
+    for (j = 0; j < n; j++)
+    {
+      init_area(&areas[i + j]);
+      for (k = 0; k < len; k++)
+        refine_area(&areas[i + j], k, values[j * len + k]);
+    }
+  }
+
+  return count;
+}
+
+/*
+ * Maps value in [min, min + span] to the index of its 1/2^32 cell.
+ *
+ * The cell boundaries min + q * span / 2^32 are exactly representable
+ * doubles, so after the floating point estimate the index is corrected
+ * against them. This makes the result bit-for-bit identical to the
+ * `value >= mid` comparisons of the bisection in GEOHASH_encode.
+ */
+static inline uint32_t
+quantize(double value, double min, double span)
+{
+  double scale = span / QUANTIZE_CELLS;
+  double q = (value - min) / scale;
+  uint64_t cell;
+
+  if (!(q > 0))
+    return 0;
+  cell = q >= (double)QUANTIZE_MAX ? QUANTIZE_MAX : (uint64_t)q;
+
+  if (cell > 0 && value < min + (double)cell * scale)
+    cell--;
+  else if (cell < QUANTIZE_MAX && value >= min + (double)(cell + 1) * scale)
+    cell++;
+
+  return (uint32_t)cell;
+}
+
+/* spreads the 32 bits of v over the even bits of a 64 bits word */
+static inline uint64_t
+spread_bits(uint32_t v)
+{
+  uint64_t x = v;
+
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x << 2)) & 0x3333333333333333ULL;
+  x = (x | (x << 1)) & 0x5555555555555555ULL;
+
+  return x;
+}
+
+/* gathers the even bits of a 64 bits word, inverse of spread_bits */
+static inline uint32_t
+compact_bits(uint64_t x)
+{
+  x &= 0x5555555555555555ULL;
+  x = (x | (x >> 1)) & 0x3333333333333333ULL;
+  x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+
+  return (uint32_t)x;
+}
+
+/* geohash bit order: longitude takes the odd bits, latitude the even ones */
+static uint64_t
+interleave_scalar(uint32_t lat, uint32_t lon)
+{
+  return (spread_bits(lon) << 1) | spread_bits(lat);
+}
+
+static void
+deinterleave_scalar(uint64_t bits, uint32_t *lat, uint32_t *lon)
+{
+  *lat = compact_bits(bits);
+  *lon = compact_bits(bits >> 1);
+}
+
+#ifdef HAVE_BMI2_DISPATCH
+__attribute__((target("bmi2"))) static uint64_t
+interleave_bmi2(uint32_t lat, uint32_t lon)
+{
+  return _pdep_u64(lon, 0xAAAAAAAAAAAAAAAAULL) | _pdep_u64(lat, 0x5555555555555555ULL);
+}
+
+__attribute__((target("bmi2"))) static void
+deinterleave_bmi2(uint64_t bits, uint32_t *lat, uint32_t *lon)
+{
+  *lat = (uint32_t)_pext_u64(bits, 0x5555555555555555ULL);
+  *lon = (uint32_t)_pext_u64(bits, 0xAAAAAAAAAAAAAAAAULL);
+}
+#endif
+
+static uint64_t interleave_resolve(uint32_t lat, uint32_t lon);
+static void deinterleave_resolve(uint64_t bits, uint32_t *lat, uint32_t *lon);
+static uint64_t (*interleave)(uint32_t lat, uint32_t lon) = interleave_resolve;
+static void (*deinterleave)(uint64_t bits, uint32_t *lat, uint32_t *lon) = deinterleave_resolve;
+
+/*
+ * Picks the interleaving implementation on first use.
+ * pdep/pext are microcoded on AMD before Zen 3, so they are only used
+ * where they are actually faster than the magic numbers version.
+ */
+static void
+resolve_interleave(void)
+{
+  uint64_t (*interleave_impl)(uint32_t, uint32_t) = interleave_scalar;
+  void (*deinterleave_impl)(uint64_t, uint32_t *, uint32_t *) = deinterleave_scalar;
+
+#ifdef HAVE_BMI2_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("bmi2") &&
+      !__builtin_cpu_is("znver1") &&
+      !__builtin_cpu_is("znver2"))
+  {
+    interleave_impl = interleave_bmi2;
+    deinterleave_impl = deinterleave_bmi2;
+  }
+#endif
+
+  interleave = interleave_impl;
+  deinterleave = deinterleave_impl;
+}
+
+static uint64_t
+interleave_resolve(uint32_t lat, uint32_t lon)
+{
+  resolve_interleave();
+  return interleave(lat, lon);
+}
+
+static void
+deinterleave_resolve(uint64_t bits, uint32_t *lat, uint32_t *lon)
+{
+  resolve_interleave();
+  deinterleave(bits, lat, lon);
+}
+
+uint64_t
+GEOHASH_encode_bits(double lat, double lon, unsigned int len)
+{
+  assert(lat >= -90.0);
+  assert(lat <= 90.0);
+  assert(lon >= -180.0);
+  assert(lon <= 180.0);
+  assert(len <= MAX_BITS_LENGTH);
+
+  if (len == 0)
+    return 0;
+
+  return interleave(quantize(lat, -90.0, 180.0), quantize(lon, -180.0, 360.0)) >> (64 - 5 * len);
+}
+
+static inline void
+bits_to_hash(uint64_t bits, unsigned int len, char *hash)
+{
+  unsigned int i;
+
+  for (i = 0; i < len; i++)
+    hash[i] = BASE32_ENCODE_TABLE[(bits >> (5 * (len - 1 - i))) & 0x1F];
+}
+
+void
+GEOHASH_encode_into(double lat, double lon, unsigned int len, char *hash)
 {
   unsigned int i;
-  char *hash;
   unsigned char bits = 0;
   double mid;
   GEOHASH_range lat_range = {90, -90};
@@ -205,10 +415,13 @@ GEOHASH_encode(double lat, double lon, unsigned int len)
   assert(lon <= 180.0);
   assert(len <= MAX_HASH_LENGTH);
 
-  hash = (char *)malloc(sizeof(char) * (len + 1));
-  if (hash == NULL)
-    return NULL;
+  if (len <= MAX_BITS_LENGTH)
+  {
+    bits_to_hash(GEOHASH_encode_bits(lat, lon, len), len, hash);
+    return;
+  }
 
+  /* longer hashes do not fit in 64 bits, keep refining the ranges */
   val1 = lon;
   range1 = &lon_range;
   val2 = lat;
@@ -233,86 +446,343 @@ GEOHASH_encode(double lat, double lon, unsigned int len)
     range1 = range2;
     range2 = range_tmp;
   }
+}
 
+char *
+GEOHASH_encode(double lat, double lon, unsigned int len)
+{
+  char *hash;
+
+  assert(len <= MAX_HASH_LENGTH);
+
+  hash = (char *)malloc(sizeof(char) * (len + 1));
+  if (hash == NULL)
+    return NULL;
+
+  GEOHASH_encode_into(lat, lon, len, hash);
   hash[len] = '\0';
   return hash;
 }
 
+/*
+ * Up to MAX_BITS_LENGTH the 5-bit values of all the hashes are written
+ * first and then translated to characters with one pass of the bulk
+ * base32 kernel.
+ */
+size_t
+GEOHASH_encode_many(const double *coordinates, size_t count, unsigned int len, char *hashes)
+{
+  size_t i;
+  unsigned int j;
+  uint64_t bits;
+  double lat, lon;
+
+  assert(len <= MAX_HASH_LENGTH);
+
+  for (i = 0; i < count; i++)
+  {
+    lat = coordinates[2 * i];
+    lon = coordinates[2 * i + 1];
+
+    if (!(lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0))
+      break;
+
+    if (len <= MAX_BITS_LENGTH)
+    {
+      bits = GEOHASH_encode_bits(lat, lon, len);
+      for (j = 0; j < len; j++)
+        hashes[i * len + j] = (bits >> (5 * (len - 1 - j))) & 0x1F;
+      continue;
+    }
+
+    GEOHASH_encode_into(lat, lon, len, hashes + i * len);
+  }
+
+  if (len <= MAX_BITS_LENGTH)
+    GEOHASH_base32_encode((const uint8_t *)hashes, i * len, hashes);
+
+  return i;
+}
+
 void GEOHASH_free_area(GEOHASH_area *area)
 {
   free(area);
 }
 
+/*
+ * Adjacency on the latitude and longitude lanes of a hash.
+ *
+ * Characters at even positions hold 3 longitude and 2 latitude bits,
+ * odd ones the other way round: moving a cell adds or subtracts 1 on one
+ * lane, wrapping around both at the antimeridian and at the poles like
+ * the neighbors tables do.
+ */
+static const int LAT_STEP[4] = {1, 0, 0, -1};
+static const int LON_STEP[4] = {0, 1, -1, 0};
+
+#define LANE3(v) ((((v) >> 2) & 4) | (((v) >> 1) & 2) | ((v)&1))
+#define LANE2(v) ((((v) >> 2) & 2) | (((v) >> 1) & 1))
+#define COMBINE(a3, b2) ((((a3)&4) << 2) | (((b2)&2) << 2) | (((a3)&2) << 1) | (((b2)&1) << 1) | ((a3)&1))
+
+#define LAT_BITS(len) GEOHASH_LAT_BITS(len)
+#define LON_BITS(len) GEOHASH_LON_BITS(len)
+#define LANE_MASK(bits) ((1ULL << (bits)) - 1)
+
+static void
+values_to_lanes(const uint8_t *values, size_t len, uint64_t *lat, uint64_t *lon)
+{
+  size_t i;
+
+  *lat = 0;
+  *lon = 0;
+
+  for (i = 0; i < len; i++)
+  {
+    if (i % 2 == 0)
+    {
+      *lon = (*lon << 3) | LANE3(values[i]);
+      *lat = (*lat << 2) | LANE2(values[i]);
+    }
+    else
+    {
+      *lat = (*lat << 3) | LANE3(values[i]);
+      *lon = (*lon << 2) | LANE2(values[i]);
+    }
+  }
+}
+
+/*
+ * Writes the hash of the lanes to out, characters whose value did not
+ * change are copied from hash so their case is preserved.
+ */
+static void
+lanes_to_hash(uint64_t lat, uint64_t lon, const uint8_t *values, const char *hash, size_t len, char *out)
+{
+  size_t i;
+  uint8_t v;
+
+  for (i = len; i-- > 0;)
+  {
+    if (i % 2 == 0)
+    {
+      v = COMBINE(lon & 7, lat & 3);
+      lon >>= 3;
+      lat >>= 2;
+    }
+    else
+    {
+      v = COMBINE(lat & 7, lon & 3);
+      lat >>= 3;
+      lon >>= 2;
+    }
+    out[i] = v == values[i] ? hash[i] : BASE32_ENCODE_TABLE[v];
+  }
+}
+
+/* walks the neighbors tables, only used for hashes longer than MAX_HASH_LENGTH */
+static bool
+adjacent_table(const char *hash, size_t len, GEOHASH_direction dir, char *adjacent)
+{
+  size_t i;
+  int idx;
+  const char *ptr;
+  char c;
+
+  if (adjacent != hash)
+    memcpy(adjacent, hash, len);
+
+  for (i = len; i-- > 0;)
+  {
+    c = tolower(adjacent[i]);
+    idx = dir * 2 + ((i + 1) % 2);
+
+    ptr = c != '\0' ? strchr(NEIGHBORS_TABLE[idx], c) : NULL;
+    if (ptr == NULL)
+      return false;
+    adjacent[i] = BASE32_ENCODE_TABLE[ptr - NEIGHBORS_TABLE[idx]];
+
+    if (strchr(BORDERS_TABLE[idx], c) == NULL)
+      break;
+  }
+
+  return true;
+}
+
+bool
+GEOHASH_get_neighbors_into(const char *hash, size_t len, GEOHASH_neighbors *neighbors)
+{
+  uint8_t values[MAX_HASH_LENGTH];
+  uint64_t lat, lon, lat_mask, lon_mask, n, s, e, w;
+
+  if (len == 0)
+    return false;
+
+  if (len > MAX_HASH_LENGTH)
+  {
+    return GEOHASH_get_adjacent_into(hash, len, GEOHASH_NORTH, neighbors->north) &&
+           GEOHASH_get_adjacent_into(hash, len, GEOHASH_EAST, neighbors->east) &&
+           GEOHASH_get_adjacent_into(hash, len, GEOHASH_WEST, neighbors->west) &&
+           GEOHASH_get_adjacent_into(hash, len, GEOHASH_SOUTH, neighbors->south) &&
+           GEOHASH_get_adjacent_into(neighbors->north, len, GEOHASH_EAST, neighbors->north_east) &&
+           GEOHASH_get_adjacent_into(neighbors->north, len, GEOHASH_WEST, neighbors->north_west) &&
+           GEOHASH_get_adjacent_into(neighbors->south, len, GEOHASH_EAST, neighbors->south_east) &&
+           GEOHASH_get_adjacent_into(neighbors->south, len, GEOHASH_WEST, neighbors->south_west);
+  }
+
+  if (!GEOHASH_base32_decode(hash, len, values))
+    return false;
+
+  values_to_lanes(values, len, &lat, &lon);
+  lat_mask = LANE_MASK(LAT_BITS(len));
+  lon_mask = LANE_MASK(LON_BITS(len));
+
+  n = (lat + 1) & lat_mask;
+  s = (lat - 1) & lat_mask;
+  e = (lon + 1) & lon_mask;
+  w = (lon - 1) & lon_mask;
+
+  lanes_to_hash(n, lon, values, hash, len, neighbors->north);
+  lanes_to_hash(lat, e, values, hash, len, neighbors->east);
+  lanes_to_hash(lat, w, values, hash, len, neighbors->west);
+  lanes_to_hash(s, lon, values, hash, len, neighbors->south);
+  lanes_to_hash(n, e, values, hash, len, neighbors->north_east);
+  lanes_to_hash(s, e, values, hash, len, neighbors->south_east);
+  lanes_to_hash(n, w, values, hash, len, neighbors->north_west);
+  lanes_to_hash(s, w, values, hash, len, neighbors->south_west);
+
+  return true;
+}
+
 GEOHASH_neighbors *
 GEOHASH_get_neighbors(const char *hash, size_t len)
 {
   GEOHASH_neighbors *neighbors;
 
-  neighbors = (GEOHASH_neighbors *)malloc(sizeof(GEOHASH_neighbors));
+  neighbors = (GEOHASH_neighbors *)calloc(1, sizeof(GEOHASH_neighbors));
   if (neighbors == NULL)
     return NULL;
 
-  neighbors->north = GEOHASH_get_adjacent(hash, len, GEOHASH_NORTH);
-  neighbors->east = GEOHASH_get_adjacent(hash, len, GEOHASH_EAST);
-  neighbors->west = GEOHASH_get_adjacent(hash, len, GEOHASH_WEST);
-  neighbors->south = GEOHASH_get_adjacent(hash, len, GEOHASH_SOUTH);
-
-  neighbors->north_east = GEOHASH_get_adjacent(neighbors->north, len, GEOHASH_EAST);
-  neighbors->north_west = GEOHASH_get_adjacent(neighbors->north, len, GEOHASH_WEST);
-  neighbors->south_east = GEOHASH_get_adjacent(neighbors->south, len, GEOHASH_EAST);
-  neighbors->south_west = GEOHASH_get_adjacent(neighbors->south, len, GEOHASH_WEST);
+  if ((neighbors->north = (char *)calloc(len + 1, 1)) == NULL ||
+      (neighbors->east = (char *)calloc(len + 1, 1)) == NULL ||
+      (neighbors->west = (char *)calloc(len + 1, 1)) == NULL ||
+      (neighbors->south = (char *)calloc(len + 1, 1)) == NULL ||
+      (neighbors->north_east = (char *)calloc(len + 1, 1)) == NULL ||
+      (neighbors->south_east = (char *)calloc(len + 1, 1)) == NULL ||
+      (neighbors->north_west = (char *)calloc(len + 1, 1)) == NULL ||
+      (neighbors->south_west = (char *)calloc(len + 1, 1)) == NULL ||
+      !GEOHASH_get_neighbors_into(hash, len, neighbors))
+  {
+    GEOHASH_free_neighbors(neighbors);
+    return NULL;
+  }
 
   return neighbors;
 }
 
-char *
-GEOHASH_get_adjacent(const char *hash, size_t len, GEOHASH_direction dir)
+bool
+GEOHASH_get_adjacent_into(const char *hash, size_t len, GEOHASH_direction dir, char *adjacent)
 {
-
-  int idx;
-  const char *border_table, *neighbor_table;
-  char *base, *refined_base, *ptr, last;
+  uint8_t values[MAX_HASH_LENGTH];
+  uint64_t lat, lon;
 
   assert(hash != NULL);
 
-  last = tolower(hash[len - 1]);
-  idx = dir * 2 + (len % 2);
+  if (len == 0)
+    return false;
 
-  border_table = BORDERS_TABLE[idx];
+  if (len > MAX_HASH_LENGTH)
+    return adjacent_table(hash, len, dir, adjacent);
 
-  base = (char *)malloc(sizeof(char) * (len + 1));
-  if (base == NULL)
-    return NULL;
-  memset(base, '\0', sizeof(char) * (len + 1));
-  strncpy(base, hash, len - 1);
+  if (!GEOHASH_base32_decode(hash, len, values))
+    return false;
 
+  values_to_lanes(values, len, &lat, &lon);
+  lat = (lat + LAT_STEP[dir]) & LANE_MASK(LAT_BITS(len));
+  lon = (lon + LON_STEP[dir]) & LANE_MASK(LON_BITS(len));
+  lanes_to_hash(lat, lon, values, hash, len, adjacent);
 
-  if (strchr(border_table, last) != NULL && len > 1)
-  {
-    refined_base = GEOHASH_get_adjacent(base, strlen(base), dir);
-    if (refined_base == NULL)
-    {
-      free(base);
-      return NULL;
-    }
-    memcpy(base, refined_base, strlen(refined_base));
-    free(refined_base);
-  }
+  return true;
+}
+
+void
+GEOHASH_bits_to_hash(uint64_t bits, unsigned int len, char *hash)
+{
+  bits_to_hash(bits, len, hash);
+}
+
+void
+GEOHASH_bits_to_lanes(uint64_t bits, unsigned int len, uint32_t *lat, uint32_t *lon)
+{
+  assert(len > 0 && len <= MAX_BITS_LENGTH);
+
+  deinterleave(bits << (64 - 5 * len), lat, lon);
+  *lat >>= 32 - LAT_BITS(len);
+  *lon >>= 32 - LON_BITS(len);
+}
+
+uint64_t
+GEOHASH_lanes_to_bits(uint32_t lat, uint32_t lon, unsigned int len)
+{
+  assert(len > 0 && len <= MAX_BITS_LENGTH);
 
-  neighbor_table = NEIGHBORS_TABLE[idx];
+  return interleave(lat << (32 - LAT_BITS(len)), lon << (32 - LON_BITS(len))) >> (64 - 5 * len);
+}
+
+uint64_t
+GEOHASH_get_adjacent_bits(uint64_t bits, unsigned int len, GEOHASH_direction dir)
+{
+  uint32_t lat, lon;
+  unsigned int shift = 64 - 5 * len;
+
+  assert(len > 0 && len <= MAX_BITS_LENGTH);
+
+  deinterleave(bits << shift, &lat, &lon);
+  lat += (uint32_t)LAT_STEP[dir] << (32 - LAT_BITS(len));
+  lon += (uint32_t)LON_STEP[dir] << (32 - LON_BITS(len));
+
+  return interleave(lat, lon) >> shift;
+}
+
+void
+GEOHASH_get_neighbors_bits(uint64_t bits, unsigned int len, uint64_t neighbors[8])
+{
+  uint32_t lat, lon, lat_one, lon_one;
+  unsigned int shift = 64 - 5 * len;
+
+  assert(len > 0 && len <= MAX_BITS_LENGTH);
+
+  /* lanes are kept left aligned so the 32 bits arithmetic wraps by itself */
+  deinterleave(bits << shift, &lat, &lon);
+  lat_one = 1u << (32 - LAT_BITS(len));
+  lon_one = 1u << (32 - LON_BITS(len));
+
+  neighbors[0] = interleave(lat + lat_one, lon) >> shift;
+  neighbors[1] = interleave(lat, lon + lon_one) >> shift;
+  neighbors[2] = interleave(lat, lon - lon_one) >> shift;
+  neighbors[3] = interleave(lat - lat_one, lon) >> shift;
+  neighbors[4] = interleave(lat + lat_one, lon + lon_one) >> shift;
+  neighbors[5] = interleave(lat - lat_one, lon + lon_one) >> shift;
+  neighbors[6] = interleave(lat + lat_one, lon - lon_one) >> shift;
+  neighbors[7] = interleave(lat - lat_one, lon - lon_one) >> shift;
+}
+
+char *
+GEOHASH_get_adjacent(const char *hash, size_t len, GEOHASH_direction dir)
+{
+  char *adjacent;
+
+  adjacent = (char *)malloc(sizeof(char) * (len + 1));
+  if (adjacent == NULL)
+    return NULL;
 
-  ptr = strchr(neighbor_table, last);
-  if (ptr == NULL)
+  if (!GEOHASH_get_adjacent_into(hash, len, dir, adjacent))
   {
-    free(base);
+    free(adjacent);
     return NULL;
   }
-  idx = (int)(ptr - neighbor_table);
-  len = strlen(base);
-  base[len] = BASE32_ENCODE_TABLE[idx];
-  base[len + 1] = '\0';
 
-  return base;
+  adjacent[len] = '\0';
+  return adjacent;
 }
 
 void GEOHASH_free_neighbors(GEOHASH_neighbors *neighbors)
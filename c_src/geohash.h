@@ -9,6 +9,18 @@ extern "C"
 {
 #endif
 
+/* longest geohash supported by GEOHASH_encode */
+#define GEOHASH_MAX_HASH_LENGTH 22
+/* longest geohash whose bits fit in an uint64_t */
+#define GEOHASH_MAX_BITS_LENGTH 12
+
+/* bits of each lane in a geohash of length len, longitude takes the odd one */
+#define GEOHASH_LAT_BITS(len) ((5 * (len)) / 2)
+#define GEOHASH_LON_BITS(len) ((5 * (len) + 1) / 2)
+
+/* mean earth radius in meters, used by the great-circle functions */
+#define GEOHASH_EARTH_RADIUS 6371008.8
+
   typedef enum
   {
     GEOHASH_NORTH = 0,
@@ -29,6 +41,13 @@ extern "C"
     GEOHASH_range longitude;
   } GEOHASH_area;
 
+  /* a geohash as its bits and its length in characters */
+  typedef struct
+  {
+    uint64_t bits;
+    unsigned int length;
+  } GEOHASH_cell;
+
   typedef struct
   {
     char *north;
@@ -44,12 +63,52 @@ extern "C"
   bool GEOHASH_verify_hash(const char *hash, size_t len);
   uint64_t GEOHASH_decode_to_bits(const char *hash, size_t len);
   char *GEOHASH_encode(double latitude, double longitude, unsigned int hash_length);
+  void GEOHASH_encode_into(double latitude, double longitude, unsigned int hash_length, char *hash);
+  uint64_t GEOHASH_encode_bits(double latitude, double longitude, unsigned int hash_length);
+  size_t GEOHASH_encode_many(const double *coordinates, size_t count, unsigned int hash_length, char *hashes);
   GEOHASH_area *GEOHASH_decode(const char *hash, size_t len);
+  bool GEOHASH_decode_into(const char *hash, size_t len, GEOHASH_area *area);
+  size_t GEOHASH_decode_many(const char *hashes, size_t count, size_t len, GEOHASH_area *areas);
   GEOHASH_neighbors *GEOHASH_get_neighbors(const char *hash, size_t len);
+  /* the fields of neighbors must point to buffers of at least len chars */
+  bool GEOHASH_get_neighbors_into(const char *hash, size_t len, GEOHASH_neighbors *neighbors);
   void GEOHASH_free_neighbors(GEOHASH_neighbors *neighbors);
   char *GEOHASH_get_adjacent(const char *hash, size_t len, GEOHASH_direction dir);
+  bool GEOHASH_get_adjacent_into(const char *hash, size_t len, GEOHASH_direction dir, char *adjacent);
   void GEOHASH_free_area(GEOHASH_area *area);
 
+  /*
+   * Integer variants working on the bits of hashes up to
+   * GEOHASH_MAX_BITS_LENGTH long, neighbors are stored in the order of
+   * the GEOHASH_neighbors fields
+   */
+  void GEOHASH_bits_to_hash(uint64_t bits, unsigned int hash_length, char *hash);
+  /* lanes are right aligned, GEOHASH_LAT_BITS and GEOHASH_LON_BITS wide */
+  void GEOHASH_bits_to_lanes(uint64_t bits, unsigned int hash_length, uint32_t *lat, uint32_t *lon);
+  uint64_t GEOHASH_lanes_to_bits(uint32_t lat, uint32_t lon, unsigned int hash_length);
+  uint64_t GEOHASH_get_adjacent_bits(uint64_t bits, unsigned int hash_length, GEOHASH_direction dir);
+  void GEOHASH_get_neighbors_bits(uint64_t bits, unsigned int hash_length, uint64_t neighbors[8]);
+
+  /*
+   * Covers of a rectangle, longitude.min > longitude.max crosses the
+   * antimeridian. Fixed precision covers are written row by row from
+   * south-west, mixed precision ones are sorted by bits.
+   */
+  uint64_t GEOHASH_cover_bbox_count(const GEOHASH_area *area, unsigned int hash_length);
+  size_t GEOHASH_cover_bbox(const GEOHASH_area *area, unsigned int hash_length, char *hashes, size_t max_cells);
+  /* cells must have room for max(max_cells, 32) cells */
+  size_t GEOHASH_cover_bbox_mixed(const GEOHASH_area *area, unsigned int max_length, size_t max_cells, GEOHASH_cell *cells);
+
+  /*
+   * Cells intersecting the great-circle disc of radius meters around a
+   * point, written row by row from south-west. The count is an upper
+   * bound, the cells of the bounding box of the disc. When inside is not
+   * NULL it flags the cells lying entirely in the disc.
+   */
+  uint64_t GEOHASH_cover_radius_count(double latitude, double longitude, double meters, unsigned int hash_length);
+  size_t GEOHASH_cover_radius(double latitude, double longitude, double meters, unsigned int hash_length,
+                              char *hashes, bool *inside);
+
 #if defined(__cplusplus)
 }
 #endif
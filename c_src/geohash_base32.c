@@ -0,0 +1,267 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HAVE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+#include "geohash_base32.h"
+
+static const char BASE32_ENCODE_TABLE[33] = "0123456789bcdefghjkmnpqrstuvwxyz";
+
+/* value + 1 of each character, 0 marks the characters outside the alphabet */
+#define LETTER(lower, upper, value) [lower] = (value) + 1, [upper] = (value) + 1
+static const uint8_t BASE32_DECODE_TABLE[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+    ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    LETTER('b', 'B', 10), LETTER('c', 'C', 11), LETTER('d', 'D', 12),
+    LETTER('e', 'E', 13), LETTER('f', 'F', 14), LETTER('g', 'G', 15),
+    LETTER('h', 'H', 16), LETTER('j', 'J', 17), LETTER('k', 'K', 18),
+    LETTER('m', 'M', 19), LETTER('n', 'N', 20), LETTER('p', 'P', 21),
+    LETTER('q', 'Q', 22), LETTER('r', 'R', 23), LETTER('s', 'S', 24),
+    LETTER('t', 'T', 25), LETTER('u', 'U', 26), LETTER('v', 'V', 27),
+    LETTER('w', 'W', 28), LETTER('x', 'X', 29), LETTER('y', 'Y', 30),
+    LETTER('z', 'Z', 31)};
+#undef LETTER
+
+static bool
+decode_scalar(const char *hash, size_t len, uint8_t *values)
+{
+  size_t i;
+  uint8_t value;
+
+  for (i = 0; i < len; i++)
+  {
+    value = BASE32_DECODE_TABLE[(uint8_t)hash[i]];
+    if (value == 0)
+      return false;
+    if (values != NULL)
+      values[i] = value - 1;
+  }
+
+  return true;
+}
+
+static void
+encode_scalar(const uint8_t *values, size_t len, char *hash)
+{
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    hash[i] = BASE32_ENCODE_TABLE[values[i] & 0x1F];
+}
+
+#ifdef HAVE_X86_DISPATCH
+
+/*
+ * After case folding, valid characters have a high nibble of 3 (digits),
+ * 6 or 7 (lowercase letters): the low nibble indexes one 16 entries table
+ * per row, -1 marks the holes of the alphabet.
+ */
+#define DECODE_ROW3 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1
+#define DECODE_ROW6 -1, -1, 10, 11, 12, 13, 14, 15, 16, -1, 17, 18, -1, 19, 20, -1
+#define DECODE_ROW7 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, -1, -1, -1, -1, -1
+
+/* characters for the values 0..15 and 16..31 */
+#define ENCODE_LOW '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'b', 'c', 'd', 'e', 'f', 'g'
+#define ENCODE_HIGH 'h', 'j', 'k', 'm', 'n', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'
+
+/* returns the 5-bit values of 16 characters, invalid ones have the high bit set */
+__attribute__((target("sse4.1"))) static inline __m128i
+translate_sse(__m128i c)
+{
+  const __m128i row3 = _mm_setr_epi8(DECODE_ROW3);
+  const __m128i row6 = _mm_setr_epi8(DECODE_ROW6);
+  const __m128i row7 = _mm_setr_epi8(DECODE_ROW7);
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  __m128i upper, hi, lo, is3, is6, is7, v;
+
+  upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+                        _mm_cmplt_epi8(c, _mm_set1_epi8('Z' + 1)));
+  c = _mm_or_si128(c, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+
+  hi = _mm_and_si128(_mm_srli_epi16(c, 4), nibble);
+  lo = _mm_and_si128(c, nibble);
+
+  is3 = _mm_cmpeq_epi8(hi, _mm_set1_epi8(3));
+  is6 = _mm_cmpeq_epi8(hi, _mm_set1_epi8(6));
+  is7 = _mm_cmpeq_epi8(hi, _mm_set1_epi8(7));
+
+  v = _mm_and_si128(is3, _mm_shuffle_epi8(row3, lo));
+  v = _mm_or_si128(v, _mm_and_si128(is6, _mm_shuffle_epi8(row6, lo)));
+  v = _mm_or_si128(v, _mm_and_si128(is7, _mm_shuffle_epi8(row7, lo)));
+
+  return _mm_or_si128(v, _mm_andnot_si128(_mm_or_si128(is3, _mm_or_si128(is6, is7)),
+                                          _mm_set1_epi8(-1)));
+}
+
+__attribute__((target("sse4.1"))) static bool
+decode_sse(const char *hash, size_t len, uint8_t *values)
+{
+  size_t i;
+  __m128i v, invalid = _mm_setzero_si128();
+
+  for (i = 0; i + 16 <= len; i += 16)
+  {
+    v = translate_sse(_mm_loadu_si128((const __m128i *)(hash + i)));
+    invalid = _mm_or_si128(invalid, v);
+    if (values != NULL)
+      _mm_storeu_si128((__m128i *)(values + i), v);
+  }
+
+  if (_mm_movemask_epi8(invalid) != 0)
+    return false;
+
+  return decode_scalar(hash + i, len - i, values != NULL ? values + i : NULL);
+}
+
+__attribute__((target("sse4.1"))) static void
+encode_sse(const uint8_t *values, size_t len, char *hash)
+{
+  const __m128i low = _mm_setr_epi8(ENCODE_LOW);
+  const __m128i high = _mm_setr_epi8(ENCODE_HIGH);
+  const __m128i bit4 = _mm_set1_epi8(0x10);
+  size_t i;
+  __m128i v, c;
+
+  for (i = 0; i + 16 <= len; i += 16)
+  {
+    v = _mm_and_si128(_mm_loadu_si128((const __m128i *)(values + i)), _mm_set1_epi8(0x1F));
+    c = _mm_blendv_epi8(_mm_shuffle_epi8(low, v), _mm_shuffle_epi8(high, v),
+                        _mm_cmpeq_epi8(_mm_and_si128(v, bit4), bit4));
+    _mm_storeu_si128((__m128i *)(hash + i), c);
+  }
+
+  encode_scalar(values + i, len - i, hash + i);
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+translate_avx2(__m256i c)
+{
+  const __m256i row3 = _mm256_setr_epi8(DECODE_ROW3, DECODE_ROW3);
+  const __m256i row6 = _mm256_setr_epi8(DECODE_ROW6, DECODE_ROW6);
+  const __m256i row7 = _mm256_setr_epi8(DECODE_ROW7, DECODE_ROW7);
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  __m256i upper, hi, lo, is3, is6, is7, v;
+
+  upper = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)),
+                           _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+  c = _mm256_or_si256(c, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+
+  hi = _mm256_and_si256(_mm256_srli_epi16(c, 4), nibble);
+  lo = _mm256_and_si256(c, nibble);
+
+  is3 = _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(3));
+  is6 = _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(6));
+  is7 = _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(7));
+
+  v = _mm256_and_si256(is3, _mm256_shuffle_epi8(row3, lo));
+  v = _mm256_or_si256(v, _mm256_and_si256(is6, _mm256_shuffle_epi8(row6, lo)));
+  v = _mm256_or_si256(v, _mm256_and_si256(is7, _mm256_shuffle_epi8(row7, lo)));
+
+  return _mm256_or_si256(v, _mm256_andnot_si256(_mm256_or_si256(is3, _mm256_or_si256(is6, is7)),
+                                                _mm256_set1_epi8(-1)));
+}
+
+__attribute__((target("avx2"))) static bool
+decode_avx2(const char *hash, size_t len, uint8_t *values)
+{
+  size_t i;
+  __m256i v, invalid = _mm256_setzero_si256();
+
+  for (i = 0; i + 32 <= len; i += 32)
+  {
+    v = translate_avx2(_mm256_loadu_si256((const __m256i *)(hash + i)));
+    invalid = _mm256_or_si256(invalid, v);
+    if (values != NULL)
+      _mm256_storeu_si256((__m256i *)(values + i), v);
+  }
+
+  if (_mm256_movemask_epi8(invalid) != 0)
+    return false;
+
+  return decode_sse(hash + i, len - i, values != NULL ? values + i : NULL);
+}
+
+__attribute__((target("avx2"))) static void
+encode_avx2(const uint8_t *values, size_t len, char *hash)
+{
+  const __m256i low = _mm256_setr_epi8(ENCODE_LOW, ENCODE_LOW);
+  const __m256i high = _mm256_setr_epi8(ENCODE_HIGH, ENCODE_HIGH);
+  const __m256i bit4 = _mm256_set1_epi8(0x10);
+  size_t i;
+  __m256i v, c;
+
+  for (i = 0; i + 32 <= len; i += 32)
+  {
+    v = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(values + i)), _mm256_set1_epi8(0x1F));
+    c = _mm256_blendv_epi8(_mm256_shuffle_epi8(low, v), _mm256_shuffle_epi8(high, v),
+                           _mm256_cmpeq_epi8(_mm256_and_si256(v, bit4), bit4));
+    _mm256_storeu_si256((__m256i *)(hash + i), c);
+  }
+
+  encode_sse(values + i, len - i, hash + i);
+}
+
+#endif
+
+static bool decode_resolve(const char *hash, size_t len, uint8_t *values);
+static void encode_resolve(const uint8_t *values, size_t len, char *hash);
+
+static bool (*decode_impl)(const char *hash, size_t len, uint8_t *values) = decode_resolve;
+static void (*encode_impl)(const uint8_t *values, size_t len, char *hash) = encode_resolve;
+
+static void
+resolve(void)
+{
+  bool (*decode)(const char *, size_t, uint8_t *) = decode_scalar;
+  void (*encode)(const uint8_t *, size_t, char *) = encode_scalar;
+
+#ifdef HAVE_X86_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+  {
+    decode = decode_avx2;
+    encode = encode_avx2;
+  }
+  else if (__builtin_cpu_supports("sse4.1"))
+  {
+    decode = decode_sse;
+    encode = encode_sse;
+  }
+#endif
+
+  decode_impl = decode;
+  encode_impl = encode;
+}
+
+static bool
+decode_resolve(const char *hash, size_t len, uint8_t *values)
+{
+  resolve();
+  return decode_impl(hash, len, values);
+}
+
+static void
+encode_resolve(const uint8_t *values, size_t len, char *hash)
+{
+  resolve();
+  encode_impl(values, len, hash);
+}
+
+bool GEOHASH_base32_decode(const char *hash, size_t len, uint8_t *values)
+{
+  return decode_impl(hash, len, values);
+}
+
+bool GEOHASH_base32_verify(const char *hash, size_t len)
+{
+  return decode_impl(hash, len, NULL);
+}
+
+void GEOHASH_base32_encode(const uint8_t *values, size_t len, char *hash)
+{
+  encode_impl(values, len, hash);
+}
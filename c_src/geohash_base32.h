@@ -0,0 +1,30 @@
+#ifndef _LIB_GEOHASH_BASE32_H_
+#define _LIB_GEOHASH_BASE32_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+  /*
+   * Bulk translation between the geohash alphabet and 5-bit values.
+   *
+   * The kernels process 32 (AVX2) or 16 (SSE4.1) characters per step when
+   * the CPU supports it, the implementation is picked on first use.
+   */
+
+  /* case insensitive, returns false if hash contains an invalid character */
+  bool GEOHASH_base32_decode(const char *hash, size_t len, uint8_t *values);
+  bool GEOHASH_base32_verify(const char *hash, size_t len);
+  /* values must be in 0..31, hash and values can be the same buffer */
+  void GEOHASH_base32_encode(const uint8_t *values, size_t len, char *hash);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
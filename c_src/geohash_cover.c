@@ -0,0 +1,483 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+#include "geohash.h"
+
+#define LAT_BITS(len) GEOHASH_LAT_BITS(len)
+#define LON_BITS(len) GEOHASH_LON_BITS(len)
+#define LANE_MAX(bits) ((uint32_t)((1ULL << (bits)) - 1))
+
+/* cells of the 32 children of a cell */
+#define CHILDREN 32
+
+#define PI 3.14159265358979323846
+#define RADIANS(degrees) ((degrees) * (PI / 180.0))
+#define DEGREES(radians) ((radians) * (180.0 / PI))
+
+/*
+ * A rectangle as ranges of lane indices at a given length.
+ * Rectangles crossing the antimeridian have two longitude ranges.
+ */
+typedef struct
+{
+  unsigned int length;
+  uint32_t lat_min;
+  uint32_t lat_max;
+  uint32_t lon_min[2];
+  uint32_t lon_max[2];
+  int lon_ranges;
+} lane_box;
+
+static void
+area_to_box(const GEOHASH_area *area, unsigned int len, lane_box *box)
+{
+  uint32_t lon_min, lon_max;
+
+  GEOHASH_bits_to_lanes(GEOHASH_encode_bits(area->latitude.min, area->longitude.min, len),
+                        len, &box->lat_min, &lon_min);
+  GEOHASH_bits_to_lanes(GEOHASH_encode_bits(area->latitude.max, area->longitude.max, len),
+                        len, &box->lat_max, &lon_max);
+
+  box->length = len;
+
+  if (area->longitude.min <= area->longitude.max)
+  {
+    box->lon_ranges = 1;
+    box->lon_min[0] = lon_min;
+    box->lon_max[0] = lon_max;
+  }
+  else if (lon_min <= lon_max)
+  {
+    /* both ends of a wrapping rectangle in the same column: every column */
+    box->lon_ranges = 1;
+    box->lon_min[0] = 0;
+    box->lon_max[0] = LANE_MAX(LON_BITS(len));
+  }
+  else
+  {
+    box->lon_ranges = 2;
+    box->lon_min[0] = lon_min;
+    box->lon_max[0] = LANE_MAX(LON_BITS(len));
+    box->lon_min[1] = 0;
+    box->lon_max[1] = lon_max;
+  }
+}
+
+/*
+ * Visits the cells of box inside the lane window
+ * [lat0, lat1] x [lon0, lon1], row by row from south-west.
+ * Only counts them when out is NULL.
+ */
+static uint64_t
+visit_box(const lane_box *box, uint32_t lat0, uint32_t lat1, uint32_t lon0, uint32_t lon1,
+          GEOHASH_cell *out)
+{
+  uint64_t count = 0, columns = 0;
+  uint32_t lat, lon, from[2], to[2];
+  int i, ranges = 0;
+
+  if (lat0 < box->lat_min)
+    lat0 = box->lat_min;
+  if (lat1 > box->lat_max)
+    lat1 = box->lat_max;
+  if (lat0 > lat1)
+    return 0;
+
+  for (i = 0; i < box->lon_ranges; i++)
+  {
+    from[ranges] = lon0 > box->lon_min[i] ? lon0 : box->lon_min[i];
+    to[ranges] = lon1 < box->lon_max[i] ? lon1 : box->lon_max[i];
+    if (from[ranges] <= to[ranges])
+    {
+      columns += (uint64_t)(to[ranges] - from[ranges]) + 1;
+      ranges++;
+    }
+  }
+
+  if (out == NULL)
+    return columns * ((uint64_t)(lat1 - lat0) + 1);
+
+  for (lat = lat0;; lat++)
+  {
+    for (i = 0; i < ranges; i++)
+    {
+      for (lon = from[i];; lon++)
+      {
+        out[count].bits = GEOHASH_lanes_to_bits(lat, lon, box->length);
+        out[count].length = box->length;
+        count++;
+        if (lon == to[i])
+          break;
+      }
+    }
+    if (lat == lat1)
+      break;
+  }
+
+  return count;
+}
+
+static uint64_t
+visit_all(const lane_box *box, GEOHASH_cell *out)
+{
+  return visit_box(box, 0, LANE_MAX(LAT_BITS(box->length)), 0, LANE_MAX(LON_BITS(box->length)), out);
+}
+
+/* bounds of the cell at lanes lat, lon, the same as GEOHASH_decode */
+static void
+lanes_area(uint32_t lat, uint32_t lon, unsigned int len, GEOHASH_area *cell)
+{
+  double lat_size = 180.0 / (double)(1ULL << LAT_BITS(len));
+  double lon_size = 360.0 / (double)(1ULL << LON_BITS(len));
+
+  cell->latitude.min = -90.0 + lat * lat_size;
+  cell->latitude.max = cell->latitude.min + lat_size;
+  cell->longitude.min = -180.0 + lon * lon_size;
+  cell->longitude.max = cell->longitude.min + lon_size;
+}
+
+/* tells if the cell lies entirely inside area */
+static bool
+cell_inside(const GEOHASH_cell *cell, const GEOHASH_area *area)
+{
+  uint32_t lat, lon;
+  GEOHASH_area bounds;
+
+  GEOHASH_bits_to_lanes(cell->bits, cell->length, &lat, &lon);
+  lanes_area(lat, lon, cell->length, &bounds);
+
+  if (bounds.latitude.min < area->latitude.min || bounds.latitude.max > area->latitude.max)
+    return false;
+
+  if (area->longitude.min <= area->longitude.max)
+    return bounds.longitude.min >= area->longitude.min && bounds.longitude.max <= area->longitude.max;
+
+  return bounds.longitude.min >= area->longitude.min || bounds.longitude.max <= area->longitude.max;
+}
+
+/* lane window of the children of cell at the next length */
+static void
+children_window(const GEOHASH_cell *cell, uint32_t *lat0, uint32_t *lat1, uint32_t *lon0, uint32_t *lon1)
+{
+  uint32_t lat, lon;
+  unsigned int lat_shift, lon_shift;
+
+  GEOHASH_bits_to_lanes(cell->bits, cell->length, &lat, &lon);
+  lat_shift = LAT_BITS(cell->length + 1) - LAT_BITS(cell->length);
+  lon_shift = LON_BITS(cell->length + 1) - LON_BITS(cell->length);
+
+  *lat0 = lat << lat_shift;
+  *lat1 = *lat0 + (1u << lat_shift) - 1;
+  *lon0 = lon << lon_shift;
+  *lon1 = *lon0 + (1u << lon_shift) - 1;
+}
+
+static int
+compare_cells(const void *a, const void *b)
+{
+  const GEOHASH_cell *x = (const GEOHASH_cell *)a, *y = (const GEOHASH_cell *)b;
+  uint64_t kx = x->bits << (64 - 5 * x->length), ky = y->bits << (64 - 5 * y->length);
+
+  if (kx != ky)
+    return kx < ky ? -1 : 1;
+  return x->length < y->length ? -1 : x->length > y->length;
+}
+
+uint64_t
+GEOHASH_cover_bbox_count(const GEOHASH_area *area, unsigned int len)
+{
+  lane_box box;
+
+  assert(len > 0 && len <= GEOHASH_MAX_BITS_LENGTH);
+
+  area_to_box(area, len, &box);
+  return visit_all(&box, NULL);
+}
+
+size_t
+GEOHASH_cover_bbox(const GEOHASH_area *area, unsigned int len, char *hashes, size_t max_cells)
+{
+  lane_box box;
+  uint32_t lat, lon;
+  int i;
+  size_t count = 0;
+
+  assert(len > 0 && len <= GEOHASH_MAX_BITS_LENGTH);
+
+  area_to_box(area, len, &box);
+  if (visit_all(&box, NULL) > max_cells)
+    return 0;
+
+  for (lat = box.lat_min;; lat++)
+  {
+    for (i = 0; i < box.lon_ranges; i++)
+    {
+      for (lon = box.lon_min[i];; lon++)
+      {
+        GEOHASH_bits_to_hash(GEOHASH_lanes_to_bits(lat, lon, len), len, hashes + count * len);
+        count++;
+        if (lon == box.lon_max[i])
+          break;
+      }
+    }
+    if (lat == box.lat_max)
+      break;
+  }
+
+  return count;
+}
+
+/*
+ * Starts from the longest fixed precision cover that fits in max_cells
+ * and then, level by level, splits the cells crossing the border of the
+ * rectangle in their intersecting children while the budget allows it.
+ */
+size_t
+GEOHASH_cover_bbox_mixed(const GEOHASH_area *area, unsigned int max_length, size_t max_cells,
+                         GEOHASH_cell *cells)
+{
+  lane_box box;
+  unsigned int len, level;
+  size_t i, count;
+  uint64_t children;
+  uint32_t lat0, lat1, lon0, lon1;
+  GEOHASH_cell split[CHILDREN];
+
+  assert(max_length > 0 && max_length <= GEOHASH_MAX_BITS_LENGTH);
+
+  for (len = 1; len < max_length; len++)
+  {
+    area_to_box(area, len + 1, &box);
+    if (visit_all(&box, NULL) > max_cells)
+      break;
+  }
+
+  area_to_box(area, len, &box);
+  count = visit_all(&box, cells);
+
+  for (level = len; level < max_length; level++)
+  {
+    area_to_box(area, level + 1, &box);
+
+    for (i = 0; i < count; i++)
+    {
+      if (cells[i].length != level || cell_inside(&cells[i], area))
+        continue;
+
+      children_window(&cells[i], &lat0, &lat1, &lon0, &lon1);
+      children = visit_box(&box, lat0, lat1, lon0, lon1, NULL);
+      if (children == 0 || count - 1 + children > max_cells)
+        continue;
+
+      visit_box(&box, lat0, lat1, lon0, lon1, split);
+      cells[i] = split[0];
+      for (children--; children > 0; children--)
+        cells[count++] = split[children];
+    }
+  }
+
+  qsort(cells, count, sizeof(GEOHASH_cell), compare_cells);
+
+  return count;
+}
+
+/* a disc on the sphere, angles in radians */
+typedef struct
+{
+  double lat;
+  double lon;
+  double angle;
+} disc;
+
+/* haversine central angle between two points */
+static double
+central_angle(double lat1, double lon1, double lat2, double lon2)
+{
+  double dlat = sin((lat2 - lat1) / 2), dlon = sin((lon2 - lon1) / 2);
+  double a = dlat * dlat + cos(lat1) * cos(lat2) * dlon * dlon;
+
+  return 2 * asin(sqrt(a < 1.0 ? a : 1.0));
+}
+
+/* longitude difference in [0, PI] */
+static double
+lon_delta(double from, double to)
+{
+  double delta = fabs(to - from);
+
+  return delta > PI ? 2 * PI - delta : delta;
+}
+
+/*
+ * Angle from the center of d to the nearest (or farthest) point of the
+ * meridian segment lon, lat0..lat1. Along a meridian the distance has a
+ * single extremum, the nearest point of the great circle when the
+ * meridian faces the center and the farthest one otherwise.
+ */
+static double
+meridian_angle(const disc *d, double lon, double lat0, double lat1, bool farthest)
+{
+  double c = cos(lon_delta(d->lon, lon));
+  double south = central_angle(d->lat, d->lon, lat0, lon);
+  double north = central_angle(d->lat, d->lon, lat1, lon);
+  double lat, angle;
+
+  if (c == 0.0 || (c > 0) == farthest)
+    return (south > north) == farthest ? south : north;
+
+  lat = atan(tan(d->lat) / c);
+  if (lat < lat0 || lat > lat1)
+  {
+    if (farthest)
+      return south > north ? south : north;
+    lat = lat < lat0 ? lat0 : lat1;
+  }
+
+  angle = central_angle(d->lat, d->lon, lat, lon);
+  if (farthest && angle < (south > north ? south : north))
+    angle = south > north ? south : north;
+
+  return angle;
+}
+
+static double
+min_angle(const disc *d, const GEOHASH_area *cell)
+{
+  double lat0 = RADIANS(cell->latitude.min), lat1 = RADIANS(cell->latitude.max);
+  double lon0 = RADIANS(cell->longitude.min), lon1 = RADIANS(cell->longitude.max);
+  double west, east;
+
+  if (d->lon >= lon0 && d->lon <= lon1)
+  {
+    if (d->lat < lat0)
+      return lat0 - d->lat;
+    if (d->lat > lat1)
+      return d->lat - lat1;
+    return 0.0;
+  }
+
+  /* along a parallel the distance grows with the longitude difference */
+  west = meridian_angle(d, lon0, lat0, lat1, false);
+  east = meridian_angle(d, lon1, lat0, lat1, false);
+
+  return west < east ? west : east;
+}
+
+static double
+max_angle(const disc *d, const GEOHASH_area *cell)
+{
+  double lat0 = RADIANS(cell->latitude.min), lat1 = RADIANS(cell->latitude.max);
+  double lon0 = RADIANS(cell->longitude.min), lon1 = RADIANS(cell->longitude.max);
+  double opposite = d->lon > 0 ? d->lon - PI : d->lon + PI;
+  double west, east;
+
+  if (opposite >= lon0 && opposite <= lon1)
+    return meridian_angle(d, opposite, lat0, lat1, true);
+
+  west = meridian_angle(d, lon0, lat0, lat1, true);
+  east = meridian_angle(d, lon1, lat0, lat1, true);
+
+  return west > east ? west : east;
+}
+
+/* bounding box of the disc, clamped at the poles and wrapping at the antimeridian */
+static void
+disc_to_box(const disc *d, unsigned int len, lane_box *box)
+{
+  GEOHASH_area area;
+  double lon_angle, ratio;
+
+  area.latitude.min = -90.0;
+  area.latitude.max = 90.0;
+  area.longitude.min = -180.0;
+  area.longitude.max = 180.0;
+
+  if (d->angle < PI)
+  {
+    if (d->lat - d->angle > -PI / 2)
+      area.latitude.min = DEGREES(d->lat - d->angle);
+    if (d->lat + d->angle < PI / 2)
+      area.latitude.max = DEGREES(d->lat + d->angle);
+
+    ratio = sin(d->angle) / cos(d->lat);
+    if (area.latitude.min > -90.0 && area.latitude.max < 90.0 && ratio < 1.0)
+    {
+      lon_angle = asin(ratio);
+      area.longitude.min = DEGREES(d->lon - lon_angle);
+      area.longitude.max = DEGREES(d->lon + lon_angle);
+      if (area.longitude.min < -180.0)
+        area.longitude.min += 360.0;
+      if (area.longitude.max > 180.0)
+        area.longitude.max -= 360.0;
+    }
+  }
+
+  area_to_box(&area, len, box);
+}
+
+static void
+make_disc(double latitude, double longitude, double meters, disc *d)
+{
+  d->lat = RADIANS(latitude);
+  d->lon = RADIANS(longitude);
+  d->angle = meters / GEOHASH_EARTH_RADIUS;
+}
+
+uint64_t
+GEOHASH_cover_radius_count(double latitude, double longitude, double meters, unsigned int len)
+{
+  disc d;
+  lane_box box;
+
+  assert(len > 0 && len <= GEOHASH_MAX_BITS_LENGTH);
+
+  make_disc(latitude, longitude, meters, &d);
+  disc_to_box(&d, len, &box);
+
+  return visit_all(&box, NULL);
+}
+
+size_t
+GEOHASH_cover_radius(double latitude, double longitude, double meters, unsigned int len,
+                     char *hashes, bool *inside)
+{
+  disc d;
+  lane_box box;
+  GEOHASH_area cell;
+  uint32_t lat, lon;
+  int i;
+  size_t count = 0;
+
+  assert(len > 0 && len <= GEOHASH_MAX_BITS_LENGTH);
+
+  make_disc(latitude, longitude, meters, &d);
+  disc_to_box(&d, len, &box);
+
+  for (lat = box.lat_min;; lat++)
+  {
+    for (i = 0; i < box.lon_ranges; i++)
+    {
+      for (lon = box.lon_min[i];; lon++)
+      {
+        lanes_area(lat, lon, len, &cell);
+        if (min_angle(&d, &cell) <= d.angle)
+        {
+          GEOHASH_bits_to_hash(GEOHASH_lanes_to_bits(lat, lon, len), len, hashes + count * len);
+          if (inside != NULL)
+            inside[count] = max_angle(&d, &cell) <= d.angle;
+          count++;
+        }
+        if (lon == box.lon_max[i])
+          break;
+      }
+    }
+    if (lat == box.lat_max)
+      break;
+  }
+
+  return count;
+}
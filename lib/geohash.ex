@@ -54,6 +54,49 @@ defmodule Geohash do
   """
   defdelegate encode(latitude, longitude, precision \\ 11), to: Nif
 
+  @doc ~S"""
+  Encodes given coordinates to the integer value of a geohash of length `precision`
+
+  The result holds `5 * precision` bits, the same value returned by
+  `Geohash.Nif.decode_to_bits/1` for the corresponding geohash.
+  `precision` can be at most 12.
+
+  ## Examples
+  ```
+  iex> Geohash.encode_int(42.6, -5.6, 5)
+  14672002
+  ```
+  """
+  defdelegate encode_int(latitude, longitude, precision \\ 11), to: Nif
+
+  @doc ~S"""
+  Encodes a batch of coordinates to geohashes of length `precision`
+
+  `points` is either a list of `{latitude, longitude}` tuples or a binary
+  of packed native-endian float64 latitude/longitude pairs.
+
+  Batches larger than 10_000 points run on a dirty CPU scheduler.
+
+  ## Options
+  * `:precision` -- length of the geohashes (default `11`)
+  * `:as` -- controls the shape of the result. Possible values are:
+    * `:binary` (default) - a single binary of concatenated geohashes,
+      each `precision` bytes long
+    * `:list` - a list of geohashes, all sub binaries of the same buffer
+
+  ## Examples
+  ```
+  iex> Geohash.encode_many([{42.6, -5.6}, {0, 0}], precision: 5)
+  "ezs42s0000"
+
+  iex> Geohash.encode_many(<<42.6::float-native, -5.6::float-native>>, precision: 5, as: :list)
+  ["ezs42"]
+  ```
+  """
+  def encode_many(points, opts \\ []) do
+    Nif.encode_many(points, Keyword.get(opts, :precision, 11), Keyword.get(opts, :as, :binary))
+  end
+
   @doc ~S"""
   Decodes given geohash to a coordinate pair
   ## Examples
@@ -94,6 +137,109 @@ defmodule Geohash do
   """
   defdelegate bounds(hash), to: Nif
 
+  @doc ~S"""
+  Decodes a batch of geohashes to a binary of packed coordinate pairs
+
+  `hashes` is either a list of geohashes or a binary of concatenated
+  geohashes, all `:precision` characters long.
+
+  Each geohash is decoded to the native-endian latitude and longitude of
+  the center of its cell. Unlike `decode/1` the values are not rounded.
+
+  Batches larger than 10_000 hashes run on a dirty CPU scheduler.
+  Returns `{:error, "invalid hash"}` if any of the geohashes is invalid.
+
+  ## Options
+  * `:precision` -- length of each geohash, required when `hashes` is a binary
+  * `:type` -- `:float64` (default) or `:float32`
+
+  ## Examples
+  ```
+  iex> <<lat::float-native, lon::float-native>> = Geohash.decode_many(["ezs42"])
+  iex> {lat, lon}
+  {42.60498046875, -5.60302734375}
+  ```
+  """
+  def decode_many(hashes, opts \\ []) do
+    Nif.decode_many(hashes, Keyword.get(opts, :precision, 0), Keyword.get(opts, :type, :float64))
+  end
+
+  @doc ~S"""
+  Calculates bounds for a batch of geohashes as a binary of packed floats
+
+  Takes the same arguments and options as `decode_many/2`.
+  Each geohash is decoded to four native-endian floats:
+  `min_lat`, `min_lon`, `max_lat` and `max_lon`.
+
+  ## Examples
+  ```
+  iex> <<min_lat::float-native, min_lon::float-native,
+  ...>   max_lat::float-native, max_lon::float-native>> = Geohash.bounds_many("ezs42", precision: 5)
+  iex> {min_lat, min_lon, max_lat, max_lon}
+  {42.5830078125, -5.625, 42.626953125, -5.5810546875}
+  ```
+  """
+  def bounds_many(hashes, opts \\ []) do
+    Nif.bounds_many(hashes, Keyword.get(opts, :precision, 0), Keyword.get(opts, :type, :float64))
+  end
+
+  @doc ~S"""
+  Calculates the geohashes covering a rectangle
+
+  With the `:precision` option all the geohashes have that length and
+  are returned row by row, starting from the south-west corner.
+  Otherwise the rectangle is covered by at most `:max_cells` geohashes
+  of mixed length, sorted, where cells crossing the border of the
+  rectangle are split as long as the budget allows it.
+
+  A rectangle with `min_lon > max_lon` crosses the antimeridian.
+  Covers larger than 10_000 cells run on a dirty CPU scheduler.
+
+  ## Options
+  * `:precision` -- length of the geohashes of a fixed precision cover (1 to 12)
+  * `:max_cells` -- maximum number of cells. Fixed precision covers
+    exceeding it return `{:error, "too many cells"}` (default `1_000_000`),
+    mixed covers default to `32` and are never smaller than the
+    precision 1 cover
+  * `:max_precision` -- maximum length of the geohashes of a mixed cover (default `12`)
+  * `:as` -- shape of a fixed precision cover, `:binary` (default) for a
+    single binary of concatenated geohashes or `:list`. Mixed covers are
+    always lists
+
+  ## Examples
+  ```
+  iex> Geohash.cover_bbox(42.6, -5.6, 42.7, -5.5, precision: 5)
+  "ezs42ezs43ezs46ezs48ezs49ezs4dezs4bezs4cezs4f"
+
+  iex> Geohash.cover_bbox(42.6, -5.6, 42.7, -5.5, max_cells: 8, max_precision: 5)
+  ["ezs4"]
+  ```
+  """
+  def cover_bbox(min_lat, min_lon, max_lat, max_lon, opts \\ []) do
+    case Keyword.fetch(opts, :precision) do
+      {:ok, precision} ->
+        Nif.cover_bbox(
+          min_lat,
+          min_lon,
+          max_lat,
+          max_lon,
+          precision,
+          Keyword.get(opts, :max_cells, 1_000_000),
+          Keyword.get(opts, :as, :binary)
+        )
+
+      :error ->
+        Nif.cover_bbox_mixed(
+          min_lat,
+          min_lon,
+          max_lat,
+          max_lon,
+          Keyword.get(opts, :max_precision, 12),
+          Keyword.get(opts, :max_cells, 32)
+        )
+    end
+  end
+
   @doc ~S"""
   Calculate adjacent hashes for the 8 touching `neighbors/2`
 
@@ -9,10 +9,29 @@ defmodule Geohash.Nif do
   @doc false
   def encode(_latitude, _longitude, _length \\ 11)
   def encode(_latitude, _longitude, _length), do: :erlang.nif_error(:nif_not_loaded)
+  def encode_int(_latitude, _longitude, _length \\ 11)
+  def encode_int(_latitude, _longitude, _length), do: :erlang.nif_error(:nif_not_loaded)
+
+  def encode_many(_points, _length, format) when format in [:binary, :list],
+    do: :erlang.nif_error(:nif_not_loaded)
+
   def decode(hash) when is_binary(hash), do: :erlang.nif_error(:nif_not_loaded)
   def decode_to_bits(hash) when is_binary(hash), do: :erlang.nif_error(:nif_not_loaded)
   def bounds(hash) when is_binary(hash), do: :erlang.nif_error(:nif_not_loaded)
 
+  def decode_many(_hashes, _length, type) when type in [:float64, :float32],
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def bounds_many(_hashes, _length, type) when type in [:float64, :float32],
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def cover_bbox(_min_lat, _min_lon, _max_lat, _max_lon, _length, _max_cells, format)
+      when format in [:binary, :list],
+      do: :erlang.nif_error(:nif_not_loaded)
+
+  def cover_bbox_mixed(_min_lat, _min_lon, _max_lat, _max_lon, _max_length, _max_cells),
+    do: :erlang.nif_error(:nif_not_loaded)
+
   def neighbors(hash) when is_binary(hash), do: :erlang.nif_error(:nif_not_loaded)
   def neighbors2(hash) when is_binary(hash), do: :erlang.nif_error(:nif_not_loaded)
 
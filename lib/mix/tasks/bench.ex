@@ -1,7 +1,15 @@
 defmodule Mix.Tasks.Bench do
   use Mix.Task
 
-  @bench_funcs ["encode", "decode", "bounds", "adjacent", "neighbors", "decode_to_bits"]
+  @bench_funcs [
+    "encode",
+    "decode",
+    "bounds",
+    "adjacent",
+    "neighbors",
+    "decode_to_bits",
+    "encode_many"
+  ]
   @preferred_cli_env :test
   @shortdoc "Bench Geohash NIF against Gehohash native Elixir implementation"
   @moduledoc """
@@ -1,4 +1,5 @@
 #include <string.h>
+#include <stdlib.h>
 #include <stdint.h>
 #include <math.h>
 #include <assert.h>
@@ -10,11 +11,20 @@
 #define BOUNDARIES 4
 #define NEIGHBORS 8
 
+/* batches with more elements than this run on a dirty CPU scheduler */
+#define DIRTY_THRESHOLD 10000
+/* areas decoded at once by the batch decoders */
+#define DECODE_CHUNK 256
+
 struct atoms
 {
   ERL_NIF_TERM atom_true;
   ERL_NIF_TERM atom_false;
   ERL_NIF_TERM atom_error;
+  ERL_NIF_TERM atom_binary;
+  ERL_NIF_TERM atom_list;
+  ERL_NIF_TERM atom_float32;
+  ERL_NIF_TERM atom_float64;
 
   ERL_NIF_TERM boundaries_atoms[BOUNDARIES];
   ERL_NIF_TERM neighbors_atoms[NEIGHBORS];
@@ -55,6 +65,171 @@ inline ERL_NIF_TERM make_binary(ErlNifEnv *env, const char *value, size_t size)
   return term;
 }
 
+static int get_coordinate(ErlNifEnv *env, ERL_NIF_TERM term, double *value)
+{
+  int int_value;
+  if (enif_get_int(env, term, &int_value))
+  {
+    *value = (double)int_value;
+    return 1;
+  }
+
+  return enif_get_double(env, term, value);
+}
+
+/*
+ * Coordinates of a batch, either borrowed from a binary of packed
+ * native-endian float64 {lat, lon} pairs or copied from a list of tuples.
+ */
+struct points
+{
+  const double *coordinates;
+  size_t count;
+  double *buffer;
+};
+
+static int get_points(ErlNifEnv *env, ERL_NIF_TERM term, struct points *points)
+{
+  ErlNifBinary bin;
+  unsigned int length;
+  size_t i;
+  int arity;
+  const ERL_NIF_TERM *tuple;
+  ERL_NIF_TERM head, tail;
+
+  points->buffer = NULL;
+
+  if (enif_inspect_binary(env, term, &bin))
+  {
+    if (bin.size % (2 * sizeof(double)) != 0)
+      return 0;
+
+    points->count = bin.size / (2 * sizeof(double));
+
+    if ((uintptr_t)bin.data % sizeof(double) == 0)
+    {
+      points->coordinates = (const double *)bin.data;
+      return 1;
+    }
+
+    /* sub binaries can start anywhere, realign them */
+    points->buffer = enif_alloc(bin.size + 1);
+    if (points->buffer == NULL)
+      return 0;
+    memcpy(points->buffer, bin.data, bin.size);
+    points->coordinates = points->buffer;
+    return 1;
+  }
+
+  if (!enif_get_list_length(env, term, &length))
+    return 0;
+
+  points->count = length;
+  points->buffer = enif_alloc(2 * sizeof(double) * length + 1);
+  if (points->buffer == NULL)
+    return 0;
+  points->coordinates = points->buffer;
+
+  for (i = 0; enif_get_list_cell(env, term, &head, &tail); i++, term = tail)
+  {
+    if (!enif_get_tuple(env, head, &arity, &tuple) || arity != 2 ||
+        !get_coordinate(env, tuple[0], &points->buffer[2 * i]) ||
+        !get_coordinate(env, tuple[1], &points->buffer[2 * i + 1]))
+    {
+      enif_free(points->buffer);
+      points->buffer = NULL;
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+static void release_points(struct points *points)
+{
+  if (points->buffer != NULL)
+    enif_free(points->buffer);
+}
+
+/*
+ * Geohashes of a batch, either a binary of concatenated hashes of the same
+ * length or a list of binaries.
+ */
+struct hashes
+{
+  ErlNifBinary bin;
+  ERL_NIF_TERM list;
+  size_t length;
+  size_t count;
+  int is_list;
+};
+
+static int get_hashes(ErlNifEnv *env, ERL_NIF_TERM term, unsigned int length, struct hashes *hashes)
+{
+  unsigned int count;
+
+  if (enif_inspect_binary(env, term, &hashes->bin))
+  {
+    if (length == 0 || hashes->bin.size % length != 0)
+      return 0;
+
+    hashes->is_list = 0;
+    hashes->length = length;
+    hashes->count = hashes->bin.size / length;
+    return 1;
+  }
+
+  if (!enif_get_list_length(env, term, &count))
+    return 0;
+
+  hashes->is_list = 1;
+  hashes->list = term;
+  hashes->count = count;
+  return 1;
+}
+
+/* returns the next hash of a list batch */
+static int next_hash(ErlNifEnv *env, struct hashes *hashes, ErlNifBinary *hash)
+{
+  ERL_NIF_TERM head;
+
+  return enif_get_list_cell(env, hashes->list, &head, &hashes->list) &&
+         enif_inspect_binary(env, head, hash);
+}
+
+static unsigned char *put_value(unsigned char *out, double value, int is_float32)
+{
+  if (is_float32)
+  {
+    float f = (float)value;
+    memcpy(out, &f, sizeof(f));
+    return out + sizeof(f);
+  }
+
+  memcpy(out, &value, sizeof(value));
+  return out + sizeof(value);
+}
+
+/*
+ * Tells if a batch given as a list or as a binary of element_size wide
+ * elements has more than DIRTY_THRESHOLD elements.
+ * Lists are only walked up to the threshold.
+ */
+static int is_large_batch(ErlNifEnv *env, ERL_NIF_TERM term, size_t element_size)
+{
+  ErlNifBinary bin;
+  ERL_NIF_TERM head;
+  size_t count = 0;
+
+  if (enif_inspect_binary(env, term, &bin))
+    return bin.size / element_size > DIRTY_THRESHOLD;
+
+  while (count <= DIRTY_THRESHOLD && enif_get_list_cell(env, term, &head, &term))
+    count++;
+
+  return count > DIRTY_THRESHOLD;
+}
+
 inline static ERL_NIF_TERM make_error(ErlNifEnv *env, const char *error)
 {
   return enif_make_tuple2(env,
@@ -62,12 +237,47 @@ inline static ERL_NIF_TERM make_error(ErlNifEnv *env, const char *error)
                           make_binary(env, error, strlen(error)));
 }
 
+/*
+ * Returns a binary of count hashes of the same length as it is
+ * (format :binary) or as a list of sub binaries (format :list)
+ */
+static ERL_NIF_TERM make_hashes(ErlNifEnv *env, ERL_NIF_TERM format, ERL_NIF_TERM bin,
+                                size_t count, size_t length)
+{
+  ERL_NIF_TERM list;
+
+  if (enif_is_identical(format, ATOMS.atom_binary))
+    return bin;
+
+  list = enif_make_list(env, 0);
+  while (count-- > 0)
+    list = enif_make_list_cell(env, enif_make_sub_binary(env, bin, count * length, length), list);
+
+  return list;
+}
+
+static int get_area(ErlNifEnv *env, const ERL_NIF_TERM argv[], GEOHASH_area *area)
+{
+  return get_coordinate(env, argv[0], &area->latitude.min) &&
+         get_coordinate(env, argv[1], &area->longitude.min) &&
+         get_coordinate(env, argv[2], &area->latitude.max) &&
+         get_coordinate(env, argv[3], &area->longitude.max) &&
+         area->latitude.min >= -90.0 && area->latitude.max <= 90.0 &&
+         area->latitude.min <= area->latitude.max &&
+         area->longitude.min >= -180.0 && area->longitude.min <= 180.0 &&
+         area->longitude.max >= -180.0 && area->longitude.max <= 180.0;
+}
+
 static int
 load(ErlNifEnv *env, void **priv, ERL_NIF_TERM load_info)
 {
   ATOMS.atom_true = make_atom(env, "true");
   ATOMS.atom_false = make_atom(env, "false");
   ATOMS.atom_error = make_atom(env, "error");
+  ATOMS.atom_binary = make_atom(env, "binary");
+  ATOMS.atom_list = make_atom(env, "list");
+  ATOMS.atom_float32 = make_atom(env, "float32");
+  ATOMS.atom_float64 = make_atom(env, "float64");
 
   ATOMS.boundaries_atoms[0] = make_atom(env, "max_lat");
   ATOMS.boundaries_atoms[1] = make_atom(env, "max_lon");
@@ -119,38 +329,281 @@ encode(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
     return enif_make_badarg(env);
   }
 
-  int int_latitude;
-  if (enif_get_int(env, argv[0], &int_latitude))
+  if (!get_coordinate(env, argv[0], &latitude) ||
+      !get_coordinate(env, argv[1], &longitude))
   {
-    latitude = (double)int_latitude;
+    return enif_make_badarg(env);
   }
-  else if (!enif_get_double(env, argv[0], &latitude))
+
+  if (!enif_get_uint(env, argv[2], &length) || length > GEOHASH_MAX_HASH_LENGTH)
   {
     return enif_make_badarg(env);
   }
 
-  int int_longitude;
-  if (enif_get_int(env, argv[1], &int_longitude))
+  ERL_NIF_TERM ret;
+  char *hash = (char *)enif_make_new_binary(env, length, &ret);
+  GEOHASH_encode_into(latitude, longitude, length, hash);
+
+  return ret;
+}
+
+/************************************************************************
+ *
+ *  Encode latitude and longitude as the integer value of a geohash
+ *  of length length (at most 12)
+ *
+ ***********************************************************************/
+
+/*
+Geohash.Nif.encode_int(42.6, -5.6, 5)
+14672002
+*/
+static ERL_NIF_TERM
+encode_int(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  double latitude, longitude;
+  unsigned int length;
+
+  if (argc != 3)
   {
-    longitude = (double)int_longitude;
+    return enif_make_badarg(env);
   }
-  else if (!enif_get_double(env, argv[1], &longitude))
+
+  if (!get_coordinate(env, argv[0], &latitude) ||
+      !get_coordinate(env, argv[1], &longitude))
   {
     return enif_make_badarg(env);
   }
 
-  if (!enif_get_uint(env, argv[2], &length))
+  if (!enif_get_uint(env, argv[2], &length) || length > GEOHASH_MAX_BITS_LENGTH)
+  {
+    return enif_make_badarg(env);
+  }
+
+  return enif_make_uint64(env, GEOHASH_encode_bits(latitude, longitude, length));
+}
+
+/************************************************************************
+ *
+ *  Encode a batch of coordinates as geohashes of length length
+ *
+ *  Coordinates are either a list of {latitude, longitude} tuples or a
+ *  binary of packed native-endian float64 latitude/longitude pairs.
+ *  The result is a single binary of fixed length hashes (format :binary)
+ *  or a list of sub binaries of it (format :list).
+ *
+ ***********************************************************************/
+
+/*
+Geohash.Nif.encode_many([{42.6, -5.6}, {0, 0}], 5, :binary)
+"ezs42s0000"
+
+Geohash.Nif.encode_many(<<42.6::float-native, -5.6::float-native>>, 5, :list)
+["ezs42"]
+*/
+static ERL_NIF_TERM
+encode_many_run(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  struct points points;
+  unsigned int length;
+  size_t encoded;
+  unsigned char *hashes;
+  ERL_NIF_TERM ret;
+
+  if (!enif_get_uint(env, argv[1], &length) || length > GEOHASH_MAX_HASH_LENGTH)
   {
     return enif_make_badarg(env);
   }
 
-  char *hash;
-  hash = GEOHASH_encode(latitude, longitude, length);
+  if (!get_points(env, argv[0], &points))
+  {
+    return enif_make_badarg(env);
+  }
 
-  ERL_NIF_TERM ret = make_binary(env, hash, length);
-  free(hash);
+  hashes = enif_make_new_binary(env, points.count * length, &ret);
+  encoded = GEOHASH_encode_many(points.coordinates, points.count, length, (char *)hashes);
+  release_points(&points);
 
-  return ret;
+  if (encoded != points.count)
+  {
+    return enif_make_badarg(env);
+  }
+
+  return make_hashes(env, argv[2], ret, points.count, length);
+}
+
+static ERL_NIF_TERM
+encode_many(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  if (argc != 3)
+  {
+    return enif_make_badarg(env);
+  }
+
+  if (!enif_is_identical(argv[2], ATOMS.atom_binary) &&
+      !enif_is_identical(argv[2], ATOMS.atom_list))
+  {
+    return enif_make_badarg(env);
+  }
+
+  if (is_large_batch(env, argv[0], 2 * sizeof(double)))
+  {
+    return enif_schedule_nif(env, "encode_many", ERL_NIF_DIRTY_JOB_CPU_BOUND,
+                             encode_many_run, argc, argv);
+  }
+
+  return encode_many_run(env, argc, argv);
+}
+
+/************************************************************************
+ *
+ *  Covers a rectangle with geohashes of length length
+ *
+ *  A rectangle with min_lon > max_lon crosses the antimeridian.
+ *  Hashes are returned row by row from south-west, as a single binary
+ *  (format :binary) or as a list of sub binaries (format :list).
+ *  Covers with more than max_cells cells are refused.
+ *
+ ***********************************************************************/
+
+/*
+Geohash.Nif.cover_bbox(42.6, -5.6, 42.7, -5.5, 5, 1000, :binary)
+"ezs42ezs43ezs46ezs48ezs49ezs4dezs4bezs4cezs4f"
+*/
+static ERL_NIF_TERM
+cover_bbox_run(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  GEOHASH_area area;
+  unsigned int length;
+  unsigned long max_cells;
+  uint64_t count;
+  char *hashes;
+  ERL_NIF_TERM ret;
+
+  if (!get_area(env, argv, &area) ||
+      !enif_get_uint(env, argv[4], &length) || length == 0 || length > GEOHASH_MAX_BITS_LENGTH ||
+      !enif_get_ulong(env, argv[5], &max_cells))
+  {
+    return enif_make_badarg(env);
+  }
+
+  count = GEOHASH_cover_bbox_count(&area, length);
+  if (count > max_cells)
+  {
+    return make_error(env, "too many cells");
+  }
+
+  hashes = (char *)enif_make_new_binary(env, count * length, &ret);
+  GEOHASH_cover_bbox(&area, length, hashes, count);
+
+  return make_hashes(env, argv[6], ret, count, length);
+}
+
+static ERL_NIF_TERM
+cover_bbox(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  GEOHASH_area area;
+  unsigned int length;
+
+  if (argc != 7)
+  {
+    return enif_make_badarg(env);
+  }
+
+  if (!get_area(env, argv, &area) ||
+      !enif_get_uint(env, argv[4], &length) || length == 0 || length > GEOHASH_MAX_BITS_LENGTH ||
+      (!enif_is_identical(argv[6], ATOMS.atom_binary) &&
+       !enif_is_identical(argv[6], ATOMS.atom_list)))
+  {
+    return enif_make_badarg(env);
+  }
+
+  if (GEOHASH_cover_bbox_count(&area, length) > DIRTY_THRESHOLD)
+  {
+    return enif_schedule_nif(env, "cover_bbox", ERL_NIF_DIRTY_JOB_CPU_BOUND,
+                             cover_bbox_run, argc, argv);
+  }
+
+  return cover_bbox_run(env, argc, argv);
+}
+
+/************************************************************************
+ *
+ *  Covers a rectangle with at most max_cells geohashes of mixed length,
+ *  up to max_length, returned as a list sorted by geohash
+ *
+ ***********************************************************************/
+
+/*
+Geohash.Nif.cover_bbox_mixed(42.6, -5.6, 42.7, -5.5, 5, 8)
+["ezs4"]
+*/
+static ERL_NIF_TERM
+cover_bbox_mixed_run(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  GEOHASH_area area;
+  unsigned int max_length;
+  unsigned long max_cells;
+  size_t i, count, size;
+  GEOHASH_cell *cells;
+  char *hashes;
+  ERL_NIF_TERM bin, list;
+
+  if (!get_area(env, argv, &area) ||
+      !enif_get_uint(env, argv[4], &max_length) ||
+      max_length == 0 || max_length > GEOHASH_MAX_BITS_LENGTH ||
+      !enif_get_ulong(env, argv[5], &max_cells) || max_cells == 0)
+  {
+    return enif_make_badarg(env);
+  }
+
+  cells = (GEOHASH_cell *)enif_alloc(sizeof(GEOHASH_cell) * (max_cells > 32 ? max_cells : 32));
+  if (cells == NULL)
+  {
+    return make_error(env, "out of memory");
+  }
+
+  count = GEOHASH_cover_bbox_mixed(&area, max_length, max_cells, cells);
+
+  for (i = 0, size = 0; i < count; i++)
+    size += cells[i].length;
+
+  hashes = (char *)enif_make_new_binary(env, size, &bin);
+  for (i = 0; i < count; i++)
+  {
+    GEOHASH_bits_to_hash(cells[i].bits, cells[i].length, hashes);
+    hashes += cells[i].length;
+  }
+
+  list = enif_make_list(env, 0);
+  while (count-- > 0)
+  {
+    size -= cells[count].length;
+    list = enif_make_list_cell(env, enif_make_sub_binary(env, bin, size, cells[count].length), list);
+  }
+
+  enif_free(cells);
+
+  return list;
+}
+
+static ERL_NIF_TERM
+cover_bbox_mixed(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  unsigned long max_cells;
+
+  if (argc != 6)
+  {
+    return enif_make_badarg(env);
+  }
+
+  if (enif_get_ulong(env, argv[5], &max_cells) && max_cells > DIRTY_THRESHOLD)
+  {
+    return enif_schedule_nif(env, "cover_bbox_mixed", ERL_NIF_DIRTY_JOB_CPU_BOUND,
+                             cover_bbox_mixed_run, argc, argv);
+  }
+
+  return cover_bbox_mixed_run(env, argc, argv);
 }
 
 /************************************************************************
@@ -178,26 +631,23 @@ decode(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
     return enif_make_badarg(env);
   }
 
-  GEOHASH_area *area;
-  area = GEOHASH_decode((const char *)hash.data, hash.size);
-
-  if (area == NULL)
+  GEOHASH_area area;
+  if (!GEOHASH_decode_into((const char *)hash.data, hash.size, &area))
   {
     return make_error(env, "invalid hash");
   }
 
-  unsigned short lat_decimals = floor(2 - log10(area->latitude.max - area->latitude.min));
-  double latitude = _round((area->latitude.min + area->latitude.max) / 2, lat_decimals);
+  unsigned short lat_decimals = floor(2 - log10(area.latitude.max - area.latitude.min));
+  double latitude = _round((area.latitude.min + area.latitude.max) / 2, lat_decimals);
 
-  unsigned short lon_decimals = floor(2 - log10(area->longitude.max - area->longitude.min));
-  double longitude = _round((area->longitude.min + area->longitude.max) / 2, lon_decimals);
+  unsigned short lon_decimals = floor(2 - log10(area.longitude.max - area.longitude.min));
+  double longitude = _round((area.longitude.min + area.longitude.max) / 2, lon_decimals);
 
   ERL_NIF_TERM ret = enif_make_tuple2(env,
                                       enif_make_double(env, latitude),
                                       enif_make_double(env, longitude));
 
   enif_release_binary(&hash);
-  GEOHASH_free_area(area);
 
   return ret;
 }
@@ -228,9 +678,8 @@ bounds(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
     return enif_make_badarg(env);
   }
 
-  GEOHASH_area *area;
-  area = GEOHASH_decode((const char *)hash.data, hash.size);
-  if (area == NULL)
+  GEOHASH_area area;
+  if (!GEOHASH_decode_into((const char *)hash.data, hash.size, &area))
   {
     enif_release_binary(&hash);
     return make_error(env, "invalid hash");
@@ -238,20 +687,179 @@ bounds(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
 
   ERL_NIF_TERM ret;
   ERL_NIF_TERM values[BOUNDARIES] = {
-      enif_make_double(env, area->latitude.max),
-      enif_make_double(env, area->longitude.max),
-      enif_make_double(env, area->latitude.min),
-      enif_make_double(env, area->longitude.min),
+      enif_make_double(env, area.latitude.max),
+      enif_make_double(env, area.longitude.max),
+      enif_make_double(env, area.latitude.min),
+      enif_make_double(env, area.longitude.min),
   };
 
   enif_make_map_from_arrays(env, ATOMS.boundaries_atoms, values, BOUNDARIES, &ret);
 
   enif_release_binary(&hash);
-  GEOHASH_free_area(area);
 
   return ret;
 }
 
+/************************************************************************
+ *
+ *  Decodes a batch of geohashes to a packed binary of floats
+ *
+ *  Geohashes are either a list of binaries or a binary of concatenated
+ *  hashes of length length.
+ *  Each hash is written as values native-endian floats of type :float64
+ *  or :float32: the center {lat, lon} when values is 2, the bounds
+ *  {min_lat, min_lon, max_lat, max_lon} when values is 4.
+ *
+ ***********************************************************************/
+
+static ERL_NIF_TERM
+decode_batch(ErlNifEnv *env, const ERL_NIF_TERM argv[], unsigned int values)
+{
+  struct hashes hashes;
+  unsigned int length;
+  size_t i, j, n;
+  int is_float32;
+  unsigned char *out;
+  ErlNifBinary hash;
+  GEOHASH_area areas[DECODE_CHUNK], *area;
+  ERL_NIF_TERM ret;
+
+  if (!enif_get_uint(env, argv[1], &length) || !get_hashes(env, argv[0], length, &hashes))
+  {
+    return enif_make_badarg(env);
+  }
+
+  is_float32 = enif_is_identical(argv[2], ATOMS.atom_float32);
+  out = enif_make_new_binary(env, hashes.count * values * (is_float32 ? sizeof(float) : sizeof(double)), &ret);
+
+  for (i = 0; i < hashes.count; i += n)
+  {
+    n = hashes.count - i < DECODE_CHUNK ? hashes.count - i : DECODE_CHUNK;
+
+    if (hashes.is_list)
+    {
+      for (j = 0; j < n; j++)
+      {
+        if (!next_hash(env, &hashes, &hash))
+        {
+          return enif_make_badarg(env);
+        }
+        if (GEOHASH_decode_many((const char *)hash.data, 1, hash.size, &areas[j]) != 1)
+        {
+          return make_error(env, "invalid hash");
+        }
+      }
+    }
+    else if (GEOHASH_decode_many((const char *)hashes.bin.data + i * hashes.length,
+                                 n, hashes.length, areas) != n)
+    {
+      return make_error(env, "invalid hash");
+    }
+
+    for (j = 0, area = areas; j < n; j++, area++)
+    {
+      if (values == 2)
+      {
+        out = put_value(out, (area->latitude.min + area->latitude.max) / 2, is_float32);
+        out = put_value(out, (area->longitude.min + area->longitude.max) / 2, is_float32);
+      }
+      else
+      {
+        out = put_value(out, area->latitude.min, is_float32);
+        out = put_value(out, area->longitude.min, is_float32);
+        out = put_value(out, area->latitude.max, is_float32);
+        out = put_value(out, area->longitude.max, is_float32);
+      }
+    }
+  }
+
+  return ret;
+}
+
+static ERL_NIF_TERM
+decode_many_run(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  return decode_batch(env, argv, 2);
+}
+
+static ERL_NIF_TERM
+bounds_many_run(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  return decode_batch(env, argv, 4);
+}
+
+/*
+ * Checks the arguments shared by decode_many/3 and bounds_many/3 and
+ * moves large batches to a dirty scheduler.
+ */
+static ERL_NIF_TERM
+schedule_decode_batch(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[],
+                      const char *name, ERL_NIF_TERM (*run)(ErlNifEnv *, int, const ERL_NIF_TERM[]))
+{
+  unsigned int length;
+
+  if (argc != 3)
+  {
+    return enif_make_badarg(env);
+  }
+
+  if (!enif_get_uint(env, argv[1], &length) ||
+      (!enif_is_identical(argv[2], ATOMS.atom_float64) &&
+       !enif_is_identical(argv[2], ATOMS.atom_float32)))
+  {
+    return enif_make_badarg(env);
+  }
+
+  if (is_large_batch(env, argv[0], length > 0 ? length : 1))
+  {
+    return enif_schedule_nif(env, name, ERL_NIF_DIRTY_JOB_CPU_BOUND, run, argc, argv);
+  }
+
+  return run(env, argc, argv);
+}
+
+/*
+Geohash.Nif.decode_many(["ezs42", "s0000"], 0, :float64)
+<<42.60498046875::float-native, -5.60302734375::float-native,
+  0.02197265625::float-native, 0.02197265625::float-native>>
+*/
+static ERL_NIF_TERM
+decode_many(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  return schedule_decode_batch(env, argc, argv, "decode_many", decode_many_run);
+}
+
+/*
+Geohash.Nif.bounds_many("ezs42", 5, :float64)
+<<42.5830078125::float-native, -5.625::float-native,
+  42.626953125::float-native, -5.5810546875::float-native>>
+*/
+static ERL_NIF_TERM
+bounds_many(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
+{
+  return schedule_decode_batch(env, argc, argv, "bounds_many", bounds_many_run);
+}
+
+/*
+ * Computes the neighbors of hash straight into 8 new binaries,
+ * in the order n, s, e, w, ne, se, nw, sw
+ */
+static int make_neighbors(ErlNifEnv *env, const ErlNifBinary *hash, ERL_NIF_TERM values[NEIGHBORS])
+{
+  GEOHASH_neighbors neighbors = {
+      .north = (char *)enif_make_new_binary(env, hash->size, &values[0]),
+      .south = (char *)enif_make_new_binary(env, hash->size, &values[1]),
+      .east = (char *)enif_make_new_binary(env, hash->size, &values[2]),
+      .west = (char *)enif_make_new_binary(env, hash->size, &values[3]),
+      .north_east = (char *)enif_make_new_binary(env, hash->size, &values[4]),
+      .south_east = (char *)enif_make_new_binary(env, hash->size, &values[5]),
+      .north_west = (char *)enif_make_new_binary(env, hash->size, &values[6]),
+      .south_west = (char *)enif_make_new_binary(env, hash->size, &values[7]),
+  };
+
+  return GEOHASH_get_neighbors_into((const char *)hash->data, hash->size, &neighbors);
+}
+
 /************************************************************************
  *
  *  Returns the neighbors of a geohash as map
@@ -301,9 +909,11 @@ neighbors(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
     return make_error(env, "invalid hash");
   }
 
-  GEOHASH_neighbors *neighbors;
-  neighbors = GEOHASH_get_neighbors((const char *)(const char *)hash.data, hash.size);
-  assert(neighbors != NULL);
+  ERL_NIF_TERM values[NEIGHBORS];
+  if (!make_neighbors(env, &hash, values))
+  {
+    return make_error(env, "invalid hash");
+  }
 
   ERL_NIF_TERM ret;
 
@@ -318,22 +928,9 @@ neighbors(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
       make_binary(env, "sw", 2),
   };
 
-  ERL_NIF_TERM values[NEIGHBORS] = {
-      make_binary(env, neighbors->north, hash.size),
-      make_binary(env, neighbors->south, hash.size),
-      make_binary(env, neighbors->east, hash.size),
-      make_binary(env, neighbors->west, hash.size),
-      make_binary(env, neighbors->north_east, hash.size),
-      make_binary(env, neighbors->south_east, hash.size),
-      make_binary(env, neighbors->north_west, hash.size),
-      make_binary(env, neighbors->south_west, hash.size),
-  };
-
   enif_make_map_from_arrays(env, keys, values, NEIGHBORS, &ret);
   enif_release_binary(&hash);
 
-  GEOHASH_free_neighbors(neighbors);
-
   return ret;
 }
 
@@ -386,28 +983,17 @@ neighbors2(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
     return make_error(env, "invalid hash");
   }
 
-  GEOHASH_neighbors *neighbors;
-  neighbors = GEOHASH_get_neighbors((const char *)(const char *)hash.data, hash.size);
-  assert(neighbors != NULL);
+  ERL_NIF_TERM values[NEIGHBORS];
+  if (!make_neighbors(env, &hash, values))
+  {
+    return make_error(env, "invalid hash");
+  }
 
   ERL_NIF_TERM ret;
 
-  ERL_NIF_TERM values[NEIGHBORS] = {
-      make_binary(env, neighbors->north, hash.size),
-      make_binary(env, neighbors->south, hash.size),
-      make_binary(env, neighbors->east, hash.size),
-      make_binary(env, neighbors->west, hash.size),
-      make_binary(env, neighbors->north_east, hash.size),
-      make_binary(env, neighbors->south_east, hash.size),
-      make_binary(env, neighbors->north_west, hash.size),
-      make_binary(env, neighbors->south_west, hash.size),
-  };
-
   enif_make_map_from_arrays(env, ATOMS.neighbors_atoms, values, NEIGHBORS, &ret);
   enif_release_binary(&hash);
 
-  GEOHASH_free_neighbors(neighbors);
-
   return ret;
 }
 
@@ -470,16 +1056,16 @@ adjacent(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
     return make_error(env, "invalid direction");
   }
 
-  const char *adjacent;
-  adjacent = (const char *)GEOHASH_get_adjacent((const char *)hash.data, hash.size, dir);
-
-  assert(adjacent != NULL);
+  ERL_NIF_TERM ret;
+  char *adjacent = (char *)enif_make_new_binary(env, hash.size, &ret);
 
-  ERL_NIF_TERM ret = make_binary(env, adjacent, hash.size);
+  if (!GEOHASH_get_adjacent_into((const char *)hash.data, hash.size, dir, adjacent))
+  {
+    return make_error(env, "invalid hash");
+  }
 
   enif_release_binary(&hash);
   enif_release_binary(&direction);
-  free((void *)adjacent);
 
   return ret;
 }
@@ -529,9 +1115,15 @@ decode_to_bits(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[])
 static ErlNifFunc nif_funcs[] =
     {
         {"encode", 3, encode},
+        {"encode_int", 3, encode_int},
+        {"encode_many", 3, encode_many},
         {"decode", 1, decode},
         {"decode_to_bits", 1, decode_to_bits},
         {"bounds", 1, bounds},
+        {"decode_many", 3, decode_many},
+        {"bounds_many", 3, bounds_many},
+        {"cover_bbox", 7, cover_bbox},
+        {"cover_bbox_mixed", 6, cover_bbox_mixed},
         {"neighbors", 1, neighbors},
         {"neighbors2", 1, neighbors2},
         {"adjacent", 2, adjacent}};
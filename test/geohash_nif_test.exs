@@ -15,6 +15,41 @@ defmodule GeohashTest do
     assert Geohash.encode(-25.38262, -49.26561, 8) == "6gkzwgjz"
   end
 
+  test "Geohash.encode_int" do
+    assert Geohash.encode_int(42.6, -5.6, 5) == 0b0110111111110000010000010
+    assert Geohash.encode_int(0, 0, 2) == 0b1100000000
+    assert Geohash.encode_int(-90, -180, 12) == 0
+    assert Geohash.encode_int(90, 180, 12) == 0xFFFFFFFFFFFFFFF
+    assert Geohash.encode_int(42.6, -5.6, 0) == 0
+  end
+
+  test "Geohash.encode_many" do
+    points = [{57.64911, 10.40744}, {39.51, -76.24}, {0, 0}, {-25.38262, -49.26561}]
+    hashes = Enum.map(points, fn {lat, lon} -> Geohash.encode(lat, lon, 8) end)
+
+    packed = for {lat, lon} <- points, into: <<>>, do: <<lat::float-native, lon::float-native>>
+
+    assert Geohash.encode_many(points, precision: 8) == Enum.join(hashes)
+    assert Geohash.encode_many(packed, precision: 8) == Enum.join(hashes)
+    assert Geohash.encode_many(points, precision: 8, as: :list) == hashes
+    assert Geohash.encode_many(packed, precision: 8, as: :list) == hashes
+    assert Geohash.encode_many([], precision: 8, as: :list) == []
+
+    assert Geohash.encode_many(points, precision: 15, as: :list) ==
+             Enum.map(points, fn {lat, lon} -> Geohash.encode(lat, lon, 15) end)
+
+    assert_raise ArgumentError, fn -> Geohash.encode_many([{91.0, 0.0}]) end
+    assert_raise ArgumentError, fn -> Geohash.encode_many(<<0.0::float-native>>) end
+  end
+
+  test "Geohash.encode_many on a dirty scheduler" do
+    points = for i <- 1..20_000, do: {rem(i, 180) - 89.5, rem(i, 360) - 179.5}
+    hashes = Geohash.encode_many(points, precision: 6, as: :list)
+
+    assert length(hashes) == 20_000
+    assert hashes == Enum.map(points, fn {lat, lon} -> Geohash.encode(lat, lon, 6) end)
+  end
+
   test "Geohash.bounds" do
     assert Geohash.bounds("u4pruydqqv") == %{
              min_lon: 10.407432317733765,
@@ -50,6 +85,100 @@ defmodule GeohashTest do
     assert Geohash.decode("6gkzwgjz") == {-25.38262, -49.26561}
   end
 
+  test "Geohash.decode_many" do
+    hashes = ["ww8p1r4t8", "ezs42e44y", "u4pruydqq", "6gkzwgjz0"]
+
+    expected =
+      for hash <- hashes, into: <<>> do
+        %{min_lat: min_lat, max_lat: max_lat, min_lon: min_lon, max_lon: max_lon} =
+          Geohash.bounds(hash)
+
+        <<(min_lat + max_lat) / 2::float-native, (min_lon + max_lon) / 2::float-native>>
+      end
+
+    assert Geohash.decode_many(hashes) == expected
+    assert Geohash.decode_many(Enum.join(hashes), precision: 9) == expected
+
+    float64 = for <<lat::float-native, lon::float-native <- expected>>, do: {lat, lon}
+
+    float32 =
+      for <<lat::float-native-32, lon::float-native-32 <- Geohash.decode_many(hashes, type: :float32)>>,
+        do: {lat, lon}
+
+    assert length(float32) == length(hashes)
+
+    for {{lat, lon}, {exp_lat, exp_lon}} <- Enum.zip(float32, float64) do
+      assert_in_delta lat, exp_lat, 1.0e-4
+      assert_in_delta lon, exp_lon, 1.0e-4
+    end
+
+    assert Geohash.decode_many([]) == <<>>
+    assert Geohash.decode_many(["ezs42", "ezsa2"]) == {:error, "invalid hash"}
+    assert_raise ArgumentError, fn -> Geohash.decode_many("ezs42") end
+    assert_raise ArgumentError, fn -> Geohash.decode_many("ezs42e", precision: 5) end
+  end
+
+  test "Geohash.bounds_many" do
+    hashes = ["ww8p1r4t8", "ezs42e44y", "u4pruydqq", "6gkzwgjz0"]
+
+    expected =
+      for hash <- hashes, into: <<>> do
+        %{min_lat: min_lat, max_lat: max_lat, min_lon: min_lon, max_lon: max_lon} =
+          Geohash.bounds(hash)
+
+        <<min_lat::float-native, min_lon::float-native, max_lat::float-native,
+          max_lon::float-native>>
+      end
+
+    assert Geohash.bounds_many(hashes) == expected
+    assert Geohash.bounds_many(Enum.join(hashes), precision: 9) == expected
+    assert byte_size(Geohash.bounds_many(hashes, type: :float32)) == 4 * 4 * 4
+  end
+
+  test "Geohash.cover_bbox with fixed precision" do
+    cover = Geohash.cover_bbox(42.6, -5.6, 42.7, -5.5, precision: 5, as: :list)
+
+    assert length(cover) == 9
+    assert Geohash.encode(42.65, -5.55, 5) in cover
+    assert Enum.join(cover) == Geohash.cover_bbox(42.6, -5.6, 42.7, -5.5, precision: 5)
+
+    assert Geohash.cover_bbox(-10, 170, 10, -170, precision: 2, as: :list) ==
+             ["ry", "2n", "rz", "2p", "xb", "80", "xc", "81"]
+
+    assert Geohash.cover_bbox(-90, -180, 90, 180, precision: 3, max_cells: 100) ==
+             {:error, "too many cells"}
+
+    assert_raise ArgumentError, fn -> Geohash.cover_bbox(10, 0, -10, 1, precision: 3) end
+  end
+
+  test "Geohash.cover_bbox with mixed precision" do
+    cover = Geohash.cover_bbox(42.6, -5.6, 42.7, -5.5, max_cells: 20, max_precision: 6)
+
+    assert length(cover) <= 20
+    assert cover == Enum.sort(cover)
+    assert Enum.any?(cover, &(byte_size(&1) == 6))
+    assert Enum.any?(cover, &(byte_size(&1) == 5))
+  end
+
+  property "every point of a rectangle is in its cover" do
+    check all(
+            lat <- StreamData.float(min: -89.0, max: 89.0),
+            lon <- StreamData.float(min: -179.0, max: 179.0),
+            precision <- StreamData.integer(1..6),
+            max_runs: 300
+          ) do
+      {min_lat, min_lon, max_lat, max_lon} = {lat - 0.5, lon - 0.5, lat + 0.5, lon + 0.5}
+      cover = Geohash.cover_bbox(min_lat, min_lon, max_lat, max_lon, precision: precision, as: :list)
+      mixed = Geohash.cover_bbox(min_lat, min_lon, max_lat, max_lon, max_precision: precision)
+
+      for {dlat, dlon} <- [{-0.5, -0.5}, {0.5, 0.5}, {0.0, 0.0}, {0.25, -0.4}] do
+        hash = Geohash.encode(lat + dlat, lon + dlon, precision)
+        assert hash in cover
+        assert Enum.any?(mixed, &String.starts_with?(hash, &1))
+      end
+    end
+  end
+
   test "Geohash.neighbors" do
     assert Geohash.neighbors("6gkzwgjz") == %{
              "n" => "6gkzwgmb",
@@ -76,6 +205,16 @@ defmodule GeohashTest do
 
   test "Geohash.adjacent" do
     assert Geohash.adjacent("ww8p1r4t8", "e") == "ww8p1r4t9"
+    assert Geohash.adjacent("EZS42", "n") == "EZS48"
+    assert Geohash.adjacent("ezefr", "e") == "ezs42"
+    assert Geohash.adjacent("z", "n") == "p"
+    assert Geohash.adjacent("z", "e") == "b"
+  end
+
+  test "invalid arguments don't crash the VM" do
+    assert Geohash.adjacent("", "n") == {:error, "invalid hash"}
+    assert Geohash.neighbors("") == {:error, "invalid hash"}
+    assert_raise ArgumentError, fn -> Geohash.encode(42.6, -5.6, 23) end
   end
 
   @geobase32 '0123456789bcdefghjkmnpqrstuvwxyz'
@@ -178,6 +317,26 @@ defmodule GeohashTest do
     end
   end
 
+  defp geohash_to_int(geohash) do
+    geohash
+    |> to_charlist()
+    |> Enum.reduce(0, fn c, acc ->
+      acc * 32 + Enum.find_index(@geobase32, &(&1 == c))
+    end)
+  end
+
+  property "encode_int matches the bits of encode" do
+    check all(
+            lat <- StreamData.float(min: -90.0, max: 90.0),
+            lon <- StreamData.float(min: -180.0, max: 180.0),
+            precision <- StreamData.integer(1..12),
+            max_runs: 1_000
+          ) do
+      assert Geohash.encode_int(lat, lon, precision) ==
+               geohash_to_int(Geohash.encode(lat, lon, precision))
+    end
+  end
+
   property "coordinate encoded is inside geohash boundaries" do
     check all(
             lat <- StreamData.float(min: -90.0, max: 90.0),